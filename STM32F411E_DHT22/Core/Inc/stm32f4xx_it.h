@@ -56,7 +56,11 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 /* USER CODE BEGIN EFP */
-
+void TIM1_CC_IRQHandler(void);
+void DMA2_Stream2_IRQHandler(void);
+void DMA1_Stream5_IRQHandler(void);
+void USART2_IRQHandler(void);
+void DMA1_Stream6_IRQHandler(void);
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
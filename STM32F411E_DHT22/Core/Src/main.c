@@ -18,12 +18,14 @@
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
-#include <stdio.h>
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 
 #include "MY_DHT22.h"
+#include "MY_UART_RX.h"
+#include "MY_UART_TX.h"
+#include "fixed_fmt.h"
 
 /* USER CODE END Includes */
 
@@ -47,6 +49,14 @@ UART_HandleTypeDef huart2;
 
 /* USER CODE BEGIN PV */
 
+// TIM1 is not configured in the .ioc, its init and MSP live in USER CODE sections
+TIM_HandleTypeDef htim1;
+DMA_HandleTypeDef hdma_tim1_ch2;
+DMA_HandleTypeDef hdma_tim1_up;
+// USART2 DMA streams are set up in the USART2 MSP USER CODE section
+DMA_HandleTypeDef hdma_usart2_rx;
+DMA_HandleTypeDef hdma_usart2_tx;
+
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -54,15 +64,23 @@ void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
 static void MX_USART2_UART_Init(void);
 /* USER CODE BEGIN PFP */
-
+static void DHT22_TIM1_Init(void);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
-float TempC, Humidity;
-char uartData[50];
-char debugMsg[50];
+// Report lines are lent to the TX queue, each buffer is formatted again only once it has been sent
+char uartData[128];
+char uartDiag[128];
+uint32_t lastReadTick;
+DHT22_HandleTypeDef hdht22;
+DHT22_Sample_Typedef dhtSample;
+// Commands arrive by circular DMA, published on IDLE and half/full transfer
+UART_RX_HandleTypedef huart2rx;
+uint8_t uartRxBuffer[256];
+char uartCommand[32];
+UART_TX_HandleTypedef huart2tx;
 
 
 /* USER CODE END 0 */
@@ -102,10 +120,16 @@ int main(void)
   HAL_UART_Transmit(&huart2, (uint8_t*)testMsg, strlen(testMsg), 100);
   /* USER CODE BEGIN 2 */
 	
+    DHT22_TIM1_Init();
 	  HAL_Delay(2000);  // Add 2 second delay after initialization
-    DHT22_Init(GPIOA, GPIO_PIN_9);
+    DHT22_Init(&hdht22, GPIOA, GPIO_PIN_9);
+    DHT22_IC_Init(&hdht22, &htim1, TIM_CHANNEL_2, GPIO_AF1_TIM1);
+    DHT22_Async_Init(&hdht22, TIM_CHANNEL_1);
+    DHT22_Cache_Init(&hdht22, DHT22_MIN_INTERVAL_MS);
+    UART_RX_Start(&huart2rx, &huart2, uartRxBuffer, sizeof(uartRxBuffer), NULL);
+    UART_TX_Init(&huart2tx, &huart2);
     
-    HAL_UART_Transmit(&huart2, (uint8_t*)"System initialized\r\n", 19, 100);
+    UART_TX_SendString(&huart2tx, "System initialized\r\n");
 
   /* USER CODE END 2 */
 
@@ -113,26 +137,56 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-    // First debug message
-    HAL_UART_Transmit(&huart2, (uint8_t*)"Attempting DHT22 read...\r\n", 25, 100);
-    
-    int result = DHT22_GetTemp_Humidity(&TempC, &Humidity);
-    
-    // Print the return value
-    sprintf(debugMsg, "DHT22 read result: %d\r\n", result);
-    HAL_UART_Transmit(&huart2, (uint8_t*)debugMsg, strlen(debugMsg), 100);
-    
-    if(result == 1)
+    // "READ" reports at once instead of waiting for the next 2 second slot
+    if(UART_RX_ReadLine(&huart2rx, uartCommand, sizeof(uartCommand)) && strcmp(uartCommand, "READ") == 0)
     {
-        sprintf(uartData, "Temp (C) = %.1f\r\nHumidity (%%) = %.1f%%\r\n", TempC, Humidity);
-        HAL_UART_Transmit(&huart2, (uint8_t *)uartData, strlen(uartData), 100);
+      lastReadTick = HAL_GetTick() - 2000;
     }
-    else
+    
+    // Report every 2 seconds from the sample cache, it refreshes itself in the background when stale
+    if((HAL_GetTick() - lastReadTick) >= 2000)
     {
-        HAL_UART_Transmit(&huart2, (uint8_t*)"CRC Error!\r\n", 12, 100);
+      lastReadTick = HAL_GetTick();
+      
+      // Lines are built with the fixed-point formatter: no float printf, no heap
+      if(DHT22_Cache_Get(&hdht22, &dhtSample) && !UART_TX_Pending(&huart2tx, uartData))
+      {
+          char *p = fmt_str(uartData, "Temp (C) = ");
+          p = fmt_x10(p, dhtSample.TempX10);
+          p = fmt_str(p, "\r\nHumidity (%) = ");
+          p = fmt_x10(p, dhtSample.HumidityX10);
+          p = fmt_str(p, "%\r\nAge ");
+          p = fmt_u32(p, dhtSample.AgeMs);
+          p = fmt_str(p, (dhtSample.Flags & DHT22_SAMPLE_STALE) ? " ms (stale)\r\n" : " ms\r\n");
+          UART_TX_Send(&huart2tx, (uint8_t *)uartData, p - uartData, NULL);
+      }
+      if((dhtSample.Flags & DHT22_SAMPLE_FAILED) && !UART_TX_Pending(&huart2tx, uartDiag))
+      {
+          const DHT22_Stats_Typedef *stats = DHT22_GetStats(&hdht22);
+          
+          // Why the last acquisition failed and how often each failure mode has occurred
+          char *p = fmt_str(uartDiag, "DHT22 ");
+          p = fmt_str(p, DHT22_StatusString(dhtSample.LastStatus));
+          p = fmt_str(p, ", bit ");
+          p = fmt_i32(p, DHT22_GetFailedBit(&hdht22));
+          p = fmt_str(p, ", ok ");
+          p = fmt_u32(p, stats->Count[DHT22_OK]);
+          p = fmt_str(p, " nr ");
+          p = fmt_u32(p, stats->Count[DHT22_ERR_NO_RESPONSE]);
+          p = fmt_str(p, " to ");
+          p = fmt_u32(p, stats->Count[DHT22_ERR_TIMEOUT]);
+          p = fmt_str(p, " cs ");
+          p = fmt_u32(p, stats->Count[DHT22_ERR_CHECKSUM]);
+          p = fmt_str(p, " rg ");
+          p = fmt_u32(p, stats->Count[DHT22_ERR_RANGE]);
+          p = fmt_str(p, " rt ");
+          p = fmt_u32(p, stats->Count[DHT22_ERR_RATE]);
+          p = fmt_str(p, "\r\n");
+          UART_TX_Send(&huart2tx, (uint8_t *)uartDiag, p - uartDiag, NULL);
+      }
     }
     
-    HAL_Delay(2000);  // Increased delay to 2 seconds
+    // Main loop stays free for UART and other work while a reading is in flight
   }
   /* USER CODE END 3 */
 }
@@ -267,6 +321,126 @@ static void MX_GPIO_Init(void)
 
 /* USER CODE BEGIN 4 */
 
+/**
+  * @brief TIM1 Initialization Function: CH2 input capture (DHT22 edges), CH1 output compare (async timing)
+  * @param None
+  * @retval None
+  */
+static void DHT22_TIM1_Init(void)
+{
+  TIM_ClockConfigTypeDef sClockSourceConfig = {0};
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+  TIM_IC_InitTypeDef sConfigIC = {0};
+  TIM_OC_InitTypeDef sConfigOC = {0};
+
+  // DMA2 streams of TIM1_CH2 and TIM1_UP, initialised by HAL_TIM_Base_MspInit()
+  __HAL_RCC_DMA2_CLK_ENABLE();
+  HAL_NVIC_SetPriority(DMA2_Stream2_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream2_IRQn);
+
+  htim1.Instance = TIM1;
+  htim1.Init.Prescaler = 25-1;
+  htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim1.Init.Period = 65535;
+  htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim1.Init.RepetitionCounter = 0;
+  htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  if (HAL_TIM_Base_Init(&htim1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
+  if (HAL_TIM_ConfigClockSource(&htim1, &sClockSourceConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  if (HAL_TIM_IC_Init(&htim1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  if (HAL_TIM_OC_Init(&htim1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(&htim1, &sMasterConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sConfigIC.ICPolarity = TIM_INPUTCHANNELPOLARITY_FALLING;
+  sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+  sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+  sConfigIC.ICFilter = 3;
+  if (HAL_TIM_IC_ConfigChannel(&htim1, &sConfigIC, TIM_CHANNEL_2) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sConfigOC.OCMode = TIM_OCMODE_TIMING;
+  sConfigOC.Pulse = 0;
+  sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+  sConfigOC.OCNPolarity = TIM_OCNPOLARITY_HIGH;
+  sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+  sConfigOC.OCIdleState = TIM_OCIDLESTATE_RESET;
+  sConfigOC.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+  if (HAL_TIM_OC_ConfigChannel(&htim1, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+}
+
+/**
+  * @brief  Input capture DMA transfer complete
+  * @param  htim TIM handle
+  * @retval None
+  */
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+  DHT22_IC_CaptureCallback(htim);
+}
+
+/**
+  * @brief  Output compare delay elapsed
+  * @param  htim TIM handle
+  * @retval None
+  */
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim)
+{
+  DHT22_Async_CompareCallback(htim);
+}
+
+/**
+  * @brief  UART reception event: half/full transfer or IDLE line
+  * @param  huart UART handle
+  * @param  Size Buffer index the DMA has reached
+  * @retval None
+  */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+  UART_RX_EventCallback(huart, Size);
+}
+
+/**
+  * @brief  UART error, the HAL has stopped a DMA reception or transmission
+  * @param  huart UART handle
+  * @retval None
+  */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  UART_RX_ErrorCallback(huart);
+  UART_TX_ErrorCallback(huart);
+}
+
+/**
+  * @brief  UART transmission complete, next queued buffer
+  * @param  huart UART handle
+  * @retval None
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  UART_TX_CpltCallback(huart);
+}
+
 /* USER CODE END 4 */
 
 /**
@@ -0,0 +1,324 @@
+/*
+ * DHT22 driver test bench: runs MY_DHT22.c against simulated sensors and reports, per waveform scenario and
+ * acquisition backend, the decode success rate, the failure modes and the CPU cycles each read costs.
+ *
+ *   ./dht22_sim [-n reads] [-s seed] [-r recording.txt]
+ *
+ * A recording holds the uSec length of each line level after the sensor response delay, starting with the
+ * LOW response; an optional "# expect <temp> <humidity>" line gives the values it must decode to.
+ * Exit status is non-zero if a clean waveform failed to decode, a read reported DHT22_OK with wrong values
+ * in a scenario without glitches (a glitch can forge a frame the 8 bit checksum accepts), or the batch decoder
+ * self-check failed.
+ */
+
+#include "sim.h"
+#include "MY_DHT22.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_BUS_PORT_SENSORS	8			//Bus backend: 8 sensors on GPIOA and 8 on GPIOB
+#define BENCH_READ_GAP_US				1000	//Line idle time between reads
+
+typedef enum
+{
+	BACKEND_BITBANG = 0,
+	BACKEND_IC,
+	BACKEND_ASYNC,
+	BACKEND_BUS,
+	BACKEND_COUNT,
+}bench_backend_t;
+
+static const char *backendNames[BACKEND_COUNT] = {"bitbang", "ic", "async", "bus"};
+
+typedef struct
+{
+	uint32_t reads;
+	uint32_t status[DHT22_STATUS_COUNT];
+	uint32_t wrong;								//DHT22_OK with values that differ from what the sensor sent
+	uint64_t busy;								//CPU cycles held by the driver
+	uint64_t elapsed;							//Cycles from start of the read to the result
+}bench_result_t;
+
+//Impairment sets, first one must decode every frame
+static const sim_scenario_t scenarios[] =
+{
+	//name            jitter  glitch%  glitch   rise  badsum% absent
+	{"clean",              0,      0,       0,      0,      0, false},
+	{"jitter",          8000,      0,       0,      0,      0, false},
+	{"glitch",             0,      3,    1200,      0,      0, false},
+	{"slow-rise",          0,      0,       0,   8000,      0, false},
+	{"bad-checksum",       0,      0,       0,      0,     25, false},
+	{"combined",        6000,      2,     800,   5000,     10, false},
+	{"no-sensor",          0,      0,       0,      0,      0, true},
+};
+
+static const sim_scenario_t recordedScenario = {"recorded", 0, 0, 0, 0, 0, false};
+static bool recordingLoaded, recordingTruth;
+static int16_t recordingTemp;
+static uint16_t recordingHumid;
+
+//Peripheral handles, wired to the simulated registers
+static TIM_HandleTypeDef htim1;
+static DMA_HandleTypeDef hdma_tim1_ch2;
+static DMA_HandleTypeDef hdma_tim1_up;
+static DHT22_HandleTypeDef sensors[2*BENCH_BUS_PORT_SENSORS];
+static sim_sensor_t *models[2*BENCH_BUS_PORT_SENSORS];
+static DHT22_Bus_Typedef bus;
+
+//HAL callbacks, forwarded as in main.c
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+	DHT22_IC_CaptureCallback(htim);
+}
+
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim)
+{
+	DHT22_Async_CompareCallback(htim);
+}
+
+static void bench_setup(const sim_scenario_t *scenario, uint32_t seed, uint8_t count)
+{
+	sim_reset(scenario, seed);
+	memset(&htim1, 0, sizeof(htim1));
+	memset(&hdma_tim1_ch2, 0, sizeof(hdma_tim1_ch2));
+	memset(&hdma_tim1_up, 0, sizeof(hdma_tim1_up));
+	hdma_tim1_ch2.Instance = &sim_dma2_stream2;
+	hdma_tim1_ch2.State = HAL_DMA_STATE_READY;
+	hdma_tim1_up.Instance = &sim_dma2_stream5;
+	hdma_tim1_up.State = HAL_DMA_STATE_READY;
+	htim1.hdma[TIM_DMA_ID_CC2] = &hdma_tim1_ch2;
+	htim1.hdma[TIM_DMA_ID_UPDATE] = &hdma_tim1_up;
+	sim_attach_timer(&htim1, &sim_gpioa, GPIO_PIN_9);
+
+	if(count == 1)
+	{
+		//Single sensor on PA9 / TIM1_CH2, compare on CH1, as on the board
+		models[0] = sim_add_sensor(&sim_gpioa, GPIO_PIN_9);
+		DHT22_Init(&sensors[0], &sim_gpioa, GPIO_PIN_9);
+		//Every synthetic frame carries new random values
+		DHT22_SetRateLimit(&sensors[0], 0, 0);
+		DHT22_IC_Init(&sensors[0], &htim1, TIM_CHANNEL_2, GPIO_AF1_TIM1);
+		DHT22_Async_Init(&sensors[0], TIM_CHANNEL_1);
+		return;
+	}
+	DHT22_Bus_Init(&bus, &htim1, &hdma_tim1_up);
+	for(uint8_t i=0; i<count; i++)
+	{
+		GPIO_TypeDef *port = (i < BENCH_BUS_PORT_SENSORS) ? &sim_gpioa : &sim_gpiob;
+		uint16_t pin = 1U << (i % BENCH_BUS_PORT_SENSORS);
+
+		models[i] = sim_add_sensor(port, pin);
+		DHT22_Init(&sensors[i], port, pin);
+		DHT22_SetRateLimit(&sensors[i], 0, 0);
+		DHT22_Bus_Add(&bus, &sensors[i]);
+	}
+}
+
+//Compare a decoded reading (0.1C, 0.1%RH) with what the sensor model sent
+static void bench_check(bench_result_t *r, const sim_sensor_t *model, DHT22_Status_Typedef status, int16_t temp, uint16_t humid)
+{
+	int16_t truthTemp = model->temp_x10;
+	uint16_t truthHumid = model->humid_x10;
+
+	r->reads++;
+	r->status[status]++;
+	if(status != DHT22_OK) return;
+	if(recordingLoaded)
+	{
+		if(!recordingTruth) return;
+		truthTemp = recordingTemp;
+		truthHumid = recordingHumid;
+	}
+	else if(!model->checksum_ok)
+	{
+		r->wrong++;
+		return;
+	}
+	if(temp != truthTemp || humid != truthHumid)
+	{
+		r->wrong++;
+	}
+}
+
+static void bench_run(bench_backend_t backend, const sim_scenario_t *scenario, uint32_t seed, uint32_t reads, bench_result_t *r)
+{
+	DHT22_Status_Typedef status;
+	int16_t temp = 0;
+	uint16_t humid = 0;
+	uint8_t count = (backend == BACKEND_BUS) ? 2*BENCH_BUS_PORT_SENSORS : 1;
+	uint64_t busy0, now0;
+
+	memset(r, 0, sizeof(*r));
+	bench_setup(scenario, seed, count);
+
+	for(uint32_t n=0; n<reads; n++)
+	{
+		sim_idle(BENCH_READ_GAP_US*SIM_CYCLES_PER_US);
+		busy0 = sim_busy_cycles;
+		now0 = sim_now;
+
+		switch(backend)
+		{
+			case BACKEND_BITBANG:
+				status = DHT22_ReadX10(&sensors[0], &temp, &humid);
+				bench_check(r, models[0], status, temp, humid);
+				break;
+			case BACKEND_IC:
+				status = DHT22_IC_ReadX10(&sensors[0], &temp, &humid);
+				bench_check(r, models[0], status, temp, humid);
+				break;
+			case BACKEND_ASYNC:
+				DHT22_Async_Start(&sensors[0], NULL);
+				//Main loop is free while the reading is in flight
+				while(DHT22_Async_Poll(&sensors[0]) != DHT22_DONE && DHT22_Async_Poll(&sensors[0]) != DHT22_ERROR)
+				{
+					sim_idle(SIM_CYCLES_PER_US);
+				}
+				status = DHT22_Async_GetResultX10(&sensors[0], &temp, &humid);
+				bench_check(r, models[0], status, temp, humid);
+				break;
+			default:
+				DHT22_Bus_Start(&bus, NULL);
+				//Main loop polls the bus once per uSec
+				while(DHT22_Bus_Process(&bus) != DHT22_DONE)
+				{
+					sim_idle(SIM_CYCLES_PER_US);
+				}
+				for(uint8_t i=0; i<count; i++)
+				{
+					status = DHT22_Async_GetResultX10(&sensors[i], &temp, &humid);
+					bench_check(r, models[i], status, temp, humid);
+				}
+				break;
+		}
+		r->busy += sim_busy_cycles - busy0;
+		r->elapsed += sim_now - now0;
+	}
+}
+
+//Pack a frame as the sensor sends it: sign-magnitude temperature, checksum (plus `corrupt`)
+static void bench_frame(uint8_t *data, int16_t temp, uint16_t humid, uint8_t corrupt)
+{
+	uint16_t t = (temp < 0) ? (0x8000 | -temp) : temp;
+	
+	data[0] = humid >> 8;
+	data[1] = humid & 0xFF;
+	data[2] = t >> 8;
+	data[3] = t & 0xFF;
+	data[4] = data[0] + data[1] + data[2] + data[3] + corrupt;
+}
+
+//Known frames through DHT22_DecodeBatch(), in 0.1 units and scaled to 0.01 units
+static bool bench_batch(void)
+{
+	static const struct
+	{
+		int16_t temp;
+		uint16_t humid;
+		uint8_t corrupt;
+		DHT22_Status_Typedef status;
+		int16_t outTemp, outHumid;		//Clipped x10
+	}cases[] =
+	{
+		{ -12,  456, 0, DHT22_OK,            -12,  456},	//Sign bit
+		{  -5,  460, 0, DHT22_OK,             -5,  460},
+		{ 207,  470, 9, DHT22_ERR_CHECKSUM,  207,  470},
+		{-500,  470, 0, DHT22_ERR_RANGE,    -400,  470},
+		{ 900, 1100, 0, DHT22_ERR_RANGE,     800, 1000},
+		{ 400,  470, 0, DHT22_ERR_RATE,      400,  470},	//+40.5C in 8 sec with the checksum ok
+		{  10,  480, 0, DHT22_OK,             10,  480},	//Slew allowance grows with the gap
+		{-300,  480, 0, DHT22_ERR_RATE,     -300,  480},
+		{ -20,  900, 0, DHT22_ERR_RATE,      -20,  900},	//Humidity +42% in 4 sec
+		{   0,  600, 0, DHT22_OK,              0,  600},
+	};
+	enum { N = sizeof(cases)/sizeof(cases[0]) };
+	uint8_t frames[5*N];
+	q15_t temp[N], humid[N];
+	DHT22_Status_Typedef status[N];
+	DHT22_Batch_Typedef batch = {2000, {DHT22_TEMP_RATE_X10, DHT22_HUMIDITY_RATE_X10}, 0x4000, 1};
+	bool ok = true;
+	uint16_t good, expectGood = 0;
+	
+	for(uint8_t i=0; i<N; i++)
+	{
+		bench_frame(&frames[5*i], cases[i].temp, cases[i].humid, cases[i].corrupt);
+		if(cases[i].status == DHT22_OK) expectGood++;
+	}
+	//0.1 units: ScaleFract 0.5, Shift 1
+	good = DHT22_DecodeBatch(&batch, frames, N, temp, humid, status);
+	ok &= good == expectGood;
+	for(uint8_t i=0; i<N; i++)
+	{
+		ok &= status[i] == cases[i].status && temp[i] == cases[i].outTemp && humid[i] == cases[i].outHumid;
+	}
+	//0.01 units: ScaleFract 0.625, Shift 4
+	batch.ScaleFract = 0x5000;
+	batch.Shift = 4;
+	good = DHT22_DecodeBatch(&batch, frames, N, temp, humid, status);
+	ok &= good == expectGood;
+	for(uint8_t i=0; i<N; i++)
+	{
+		ok &= temp[i] == cases[i].outTemp*10 && humid[i] == cases[i].outHumid*10;
+	}
+	printf("batch decode (sign, range, rate, clip, scale): %s\n\n", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t reads = 100, seed = 1;
+	const char *recording = NULL;
+	const sim_scenario_t *list = scenarios;
+	uint32_t listCount = sizeof(scenarios)/sizeof(scenarios[0]);
+	bench_result_t r;
+	int failed = 0;
+
+	for(int i=1; i<argc; i++)
+	{
+		if(!strcmp(argv[i], "-n") && i+1 < argc) reads = strtoul(argv[++i], NULL, 0);
+		else if(!strcmp(argv[i], "-s") && i+1 < argc) seed = strtoul(argv[++i], NULL, 0);
+		else if(!strcmp(argv[i], "-r") && i+1 < argc) recording = argv[++i];
+		else
+		{
+			fprintf(stderr, "usage: %s [-n reads] [-s seed] [-r recording.txt]\n", argv[0]);
+			return 2;
+		}
+	}
+	if(recording != NULL)
+	{
+		if(!sim_load_recording(recording, &recordingTemp, &recordingHumid, &recordingTruth))
+		{
+			fprintf(stderr, "cannot read %s\n", recording);
+			return 2;
+		}
+		recordingLoaded = true;
+		list = &recordedScenario;
+		listCount = 1;
+	}
+
+	printf("DHT22 host simulator: %u reads per scenario and backend, seed %u, %lu MHz core\n",
+	       reads, seed, SIM_CORE_HZ/1000000);
+	printf("busy = CPU cycles held by the driver (waits on the cycle counter + %d per interrupt)\n\n", SIM_ISR_CYCLES);
+	if(!bench_batch()) failed = 1;
+	printf("%-13s %-8s %7s %6s %6s %6s %6s %6s %6s %6s %12s %10s\n",
+	       "scenario", "backend", "ok%", "ok", "nores", "tmout", "chksum", "range", "rate", "wrong", "busy/read", "us/read");
+
+	for(uint32_t s=0; s<listCount; s++)
+	{
+		for(uint8_t b=0; b<BACKEND_COUNT; b++)
+		{
+			bench_run((bench_backend_t)b, &list[s], seed, reads, &r);
+			printf("%-13s %-8s %6.1f%% %6u %6u %6u %6u %6u %6u %6u %12llu %10.1f\n",
+			       list[s].name, backendNames[b], 100.0*r.status[DHT22_OK]/r.reads,
+			       r.status[DHT22_OK], r.status[DHT22_ERR_NO_RESPONSE], r.status[DHT22_ERR_TIMEOUT],
+			       r.status[DHT22_ERR_CHECKSUM], r.status[DHT22_ERR_RANGE], r.status[DHT22_ERR_RATE], r.wrong,
+			       (unsigned long long)(r.busy/r.reads), (double)r.elapsed/r.reads/SIM_CYCLES_PER_US);
+			//An 8 bit checksum cannot catch every glitch, only clean-bit impairments must never decode wrong
+			if(r.wrong != 0 && list[s].glitch_pct == 0) failed = 1;
+			if(list == scenarios && s == 0 && r.status[DHT22_OK] != r.reads) failed = 1;
+		}
+	}
+	if(failed) printf("\nFAIL\n");
+	return failed;
+}
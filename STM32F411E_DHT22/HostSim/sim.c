@@ -0,0 +1,533 @@
+/*
+ * Host simulator for the DHT22 driver: peripherals, sensor waveforms and the HAL functions the driver calls.
+ */
+
+#include "sim.h"
+#include <stdio.h>
+#include <string.h>
+
+//HAL callbacks, provided by the test bench as main.c does on target
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim);
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim);
+
+//*** Simulated peripherals ***//
+GPIO_TypeDef sim_gpioa, sim_gpiob;
+TIM_TypeDef sim_tim1;
+DMA_Stream_TypeDef sim_dma2_stream2, sim_dma2_stream5;
+CoreDebug_Type sim_core_debug;
+DMA_TypeDef sim_dma_status;
+static DWT_Type sim_dwt_regs;
+
+//DMA stream state the registers cannot hold on a 64 bit host
+typedef struct
+{
+	DMA_Stream_TypeDef *regs;
+	volatile uint32_t *src;
+	uint16_t *dst;
+	bool enabled;
+}sim_dma_t;
+static sim_dma_t sim_dma[2] = {{&sim_dma2_stream2}, {&sim_dma2_stream5}};
+
+//Timer
+static TIM_HandleTypeDef *sim_htim;
+static GPIO_TypeDef *sim_ic_port;
+static uint16_t sim_ic_pin;
+static uint32_t sim_tim_psc_count;
+static bool sim_ic_level;
+static uint32_t sim_ic_filter_count;
+static uint32_t sim_ic_channel;
+static sim_dma_t *sim_ic_dma;
+//Pending interrupts
+static bool sim_pending_ic;
+static bool sim_pending_cc[4];
+static bool sim_in_isr;
+static bool sim_isr_ran;
+
+//Sensors
+static sim_sensor_t sim_sensors[SIM_MAX_SENSORS];
+static uint8_t sim_sensor_count;
+static const sim_scenario_t *sim_scenario;
+
+//Recorded frame, uSec per level starting with the LOW response
+static uint32_t sim_recording[SIM_MAX_SEGMENTS];
+static uint16_t sim_recording_count;
+
+//Clock and accounting
+uint64_t sim_now;
+uint64_t sim_busy_cycles;
+uint32_t sim_isr_count;
+static uint32_t sim_seed = 1;
+
+uint32_t SystemCoreClock = SIM_CORE_HZ;
+
+//xorshift32
+uint32_t sim_rand(void)
+{
+	sim_seed ^= sim_seed << 13;
+	sim_seed ^= sim_seed >> 17;
+	sim_seed ^= sim_seed << 5;
+	return sim_seed;
+}
+
+static uint32_t sim_ns_to_cycles(uint32_t ns)
+{
+	return (ns * SIM_CYCLES_PER_US + 999) / 1000;
+}
+
+//*** Sensor model ***//
+
+static void sim_segment(sim_sensor_t *s, uint8_t level, uint32_t ns)
+{
+	int32_t jitter = (int32_t)sim_scenario->jitter_ns;
+	int32_t length = (int32_t)ns;
+
+	if(s->seg_count >= SIM_MAX_SEGMENTS) return;
+	if(jitter != 0) length += (int32_t)(sim_rand() % (2*jitter + 1)) - jitter;
+	s->seg_level[s->seg_count] = level;
+	s->seg_cycles[s->seg_count] = (length > 0) ? sim_ns_to_cycles(length) : 1;
+	s->seg_count++;
+}
+
+//HIGH time of a bit, optionally split by a short LOW glitch
+static void sim_bit_high(sim_sensor_t *s, uint32_t ns)
+{
+	uint32_t glitch, at;
+
+	if(sim_scenario->glitch_pct == 0 || (sim_rand() % 100) >= sim_scenario->glitch_pct)
+	{
+		sim_segment(s, 1, ns);
+		return;
+	}
+	glitch = sim_scenario->glitch_ns/4 + sim_rand() % (sim_scenario->glitch_ns - sim_scenario->glitch_ns/4 + 1);
+	at = 3000 + sim_rand() % (ns - 6000);
+	sim_segment(s, 1, at);
+	s->seg_level[s->seg_count] = 0;
+	s->seg_cycles[s->seg_count++] = sim_ns_to_cycles(glitch);
+	sim_segment(s, 1, ns - at);
+}
+
+//Frame sent after the host releases the line
+static void sim_build_frame(sim_sensor_t *s)
+{
+	uint8_t data[5];
+	uint16_t temp;
+
+	s->seg_count = 0;
+	s->seg_idx = 0;
+	s->frames++;
+	//Response delay
+	sim_segment(s, 1, 20000 + sim_rand() % 20000);
+
+	if(sim_recording_count != 0)
+	{
+		for(uint16_t i=0; i<sim_recording_count && s->seg_count<SIM_MAX_SEGMENTS; i++)
+		{
+			s->seg_level[s->seg_count] = (i & 1);
+			s->seg_cycles[s->seg_count++] = sim_recording[i]*SIM_CYCLES_PER_US;
+		}
+	}
+	else
+	{
+		s->humid_x10 = sim_rand() % 1001;
+		s->temp_x10 = (int16_t)(sim_rand() % 1201) - 400;
+		//Sign-magnitude, as the sensor sends it
+		temp = (s->temp_x10 < 0) ? (0x8000 | -s->temp_x10) : s->temp_x10;
+		data[0] = s->humid_x10 >> 8;
+		data[1] = s->humid_x10 & 0xFF;
+		data[2] = temp >> 8;
+		data[3] = temp & 0xFF;
+		data[4] = data[0] + data[1] + data[2] + data[3];
+		s->checksum_ok = (sim_rand() % 100) >= sim_scenario->bad_checksum_pct;
+		if(!s->checksum_ok) data[4] ^= 1 << (sim_rand() % 8);
+
+		//Response: 80uSec LOW, 80uSec HIGH
+		sim_segment(s, 0, 80000);
+		sim_segment(s, 1, 80000);
+		//Bits: 50uSec LOW, then HIGH 26uSec (0) or 70uSec (1)
+		for(uint8_t i=0; i<40; i++)
+		{
+			sim_segment(s, 0, 50000);
+			sim_bit_high(s, (data[i/8] & (0x80 >> (i%8))) ? 70000 : 26000);
+		}
+		//End of frame
+		sim_segment(s, 0, 50000);
+	}
+	s->sending = true;
+	s->seg_left = s->seg_cycles[0];
+}
+
+//Host drives the pin LOW: output (push-pull or open-drain) with ODR cleared
+static bool sim_host_low(GPIO_TypeDef *port, uint16_t pin, uint8_t idx)
+{
+	return ((port->MODER >> 2*idx) & 3) == 1 && !(port->ODR & pin);
+}
+
+static void sim_sensor_step(sim_sensor_t *s)
+{
+	uint8_t idx = __builtin_ctz(s->pin);
+	bool host_low = sim_host_low(s->port, s->pin, idx);
+	bool sensor_low = false;
+
+	if(!s->sending)
+	{
+		if(host_low)
+		{
+			s->host_low_cycles++;
+		}
+		else
+		{
+			if(s->host_low_cycles >= SIM_WAKE_US*SIM_CYCLES_PER_US && !sim_scenario->absent) sim_build_frame(s);
+			s->host_low_cycles = 0;
+		}
+	}
+	if(s->sending)
+	{
+		sensor_low = (s->seg_level[s->seg_idx] == 0);
+		if(--s->seg_left == 0)
+		{
+			if(++s->seg_idx >= s->seg_count) s->sending = false;
+			else s->seg_left = s->seg_cycles[s->seg_idx];
+		}
+	}
+
+	//Line falls at once, rises through the pull-up
+	if(host_low || sensor_low)
+	{
+		s->level = 0;
+		s->rise_left = sim_ns_to_cycles(sim_scenario->rise_ns);
+	}
+	else if(!s->level)
+	{
+		if(s->rise_left == 0 || --s->rise_left == 0) s->level = 1;
+	}
+	if(s->level) s->port->IDR |= s->pin;
+	else s->port->IDR &= ~s->pin;
+}
+
+//*** Peripherals ***//
+
+static sim_dma_t *sim_dma_find(DMA_Stream_TypeDef *regs)
+{
+	for(uint8_t i=0; i<2; i++)
+	{
+		if(sim_dma[i].regs == regs) return &sim_dma[i];
+	}
+	return NULL;
+}
+
+static void sim_gpio_step(GPIO_TypeDef *port)
+{
+	//BSRR is write-only: apply and clear, reset has the lower priority
+	if(port->BSRR != 0)
+	{
+		port->ODR &= ~(port->BSRR >> 16);
+		port->ODR |= port->BSRR & 0xFFFF;
+		port->BSRR = 0;
+	}
+}
+
+static void sim_tim_step(void)
+{
+	TIM_TypeDef *tim = &sim_tim1;
+	sim_dma_t *up = sim_dma_find(&sim_dma2_stream5);
+	bool level;
+
+	//Input capture with the digital filter, timer counter latched on falling edges
+	if(sim_ic_dma != NULL && sim_ic_dma->enabled && ((sim_ic_port->MODER >> 2*__builtin_ctz(sim_ic_pin)) & 3) == 2)
+	{
+		level = (sim_ic_port->IDR & sim_ic_pin) != 0;
+		if(level != sim_ic_level)
+		{
+			if(++sim_ic_filter_count >= SIM_IC_FILTER_CYCLES)
+			{
+				sim_ic_level = level;
+				sim_ic_filter_count = 0;
+				if(!level)
+				{
+					*sim_ic_dma->dst++ = (uint16_t)tim->CNT;
+					if(--sim_ic_dma->regs->NDTR == 0)
+					{
+						sim_ic_dma->enabled = false;
+						sim_ic_dma->regs->CR &= ~DMA_SxCR_EN;
+						sim_pending_ic = true;
+					}
+				}
+			}
+		}
+		else
+		{
+			sim_ic_filter_count = 0;
+		}
+	}
+
+	if(!(tim->CR1 & TIM_CR1_CEN)) return;
+	if(++sim_tim_psc_count <= tim->PSC) return;
+	sim_tim_psc_count = 0;
+
+	if(tim->CNT >= tim->ARR)
+	{
+		tim->CNT = 0;
+		//Update event: DMA request copies the peripheral register
+		if((tim->DIER & TIM_DIER_UDE) && up->enabled)
+		{
+			*up->dst++ = (uint16_t)*up->src;
+			if(--up->regs->NDTR == 0)
+			{
+				up->enabled = false;
+				up->regs->CR &= ~DMA_SxCR_EN;
+			}
+		}
+	}
+	else
+	{
+		tim->CNT++;
+	}
+
+	//Compare match on output compare channels
+	for(uint8_t ch=0; ch<4; ch++)
+	{
+		volatile uint32_t *ccr = &tim->CCR1 + ch;
+		if(ch == sim_ic_channel/4 && (tim->CCER & (1UL << sim_ic_channel))) continue;
+		//TIM1 compare registers are 16 bit, upper bits of a write are dropped
+		if(tim->CNT == (*ccr & 0xFFFF))
+		{
+			tim->SR |= TIM_SR_CC1IF << ch;
+			if(tim->DIER & (TIM_DIER_CC1IE << ch)) sim_pending_cc[ch] = true;
+		}
+	}
+}
+
+//Interrupts the way HAL_DMA_IRQHandler/HAL_TIM_IRQHandler deliver them
+static void sim_dispatch(void)
+{
+	if(sim_in_isr || sim_htim == NULL) return;
+	sim_in_isr = true;
+	if(sim_pending_ic)
+	{
+		sim_pending_ic = false;
+		sim_isr_count++;
+		sim_isr_ran = true;
+		sim_step(SIM_ISR_CYCLES, true);
+		sim_htim->Channel = (HAL_TIM_ActiveChannel)(HAL_TIM_ACTIVE_CHANNEL_1 << (sim_ic_channel/4));
+		HAL_TIM_IC_CaptureCallback(sim_htim);
+		sim_htim->Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+	}
+	for(uint8_t ch=0; ch<4; ch++)
+	{
+		if(!sim_pending_cc[ch]) continue;
+		sim_pending_cc[ch] = false;
+		sim_isr_count++;
+		sim_isr_ran = true;
+		sim_step(SIM_ISR_CYCLES, true);
+		sim_tim1.SR &= ~(TIM_SR_CC1IF << ch);
+		sim_htim->Channel = (HAL_TIM_ActiveChannel)(HAL_TIM_ACTIVE_CHANNEL_1 << ch);
+		HAL_TIM_OC_DelayElapsedCallback(sim_htim);
+		sim_htim->Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+	}
+	sim_in_isr = false;
+}
+
+//*** Clock ***//
+
+void sim_step(uint32_t cycles, bool busy)
+{
+	while(cycles--)
+	{
+		sim_now++;
+		if(busy) sim_busy_cycles++;
+		sim_gpio_step(&sim_gpioa);
+		sim_gpio_step(&sim_gpiob);
+		for(uint8_t i=0; i<sim_sensor_count; i++)
+		{
+			sim_sensor_step(&sim_sensors[i]);
+		}
+		sim_tim_step();
+		if(!sim_in_isr && (sim_pending_ic || sim_pending_cc[0] || sim_pending_cc[1] || sim_pending_cc[2] || sim_pending_cc[3]))
+		{
+			sim_dispatch();
+		}
+	}
+}
+
+void sim_idle(uint32_t cycles)
+{
+	sim_step(cycles, false);
+}
+
+DWT_Type *sim_dwt(void)
+{
+	sim_step(SIM_POLL_CYCLES, true);
+	sim_dwt_regs.CYCCNT = (uint32_t)sim_now;
+	return &sim_dwt_regs;
+}
+
+void sim_wfi(void)
+{
+	//Sleep until an interrupt has run or the next SysTick
+	sim_isr_ran = false;
+	do
+	{
+		sim_step(1, false);
+	}while(!sim_isr_ran && (sim_now % (SIM_CORE_HZ/1000)) != 0);
+}
+
+//*** Set up ***//
+
+void sim_reset(const sim_scenario_t *scenario, uint32_t seed)
+{
+	memset(&sim_gpioa, 0, sizeof(sim_gpioa));
+	memset(&sim_gpiob, 0, sizeof(sim_gpiob));
+	memset(&sim_tim1, 0, sizeof(sim_tim1));
+	memset(&sim_dma2_stream2, 0, sizeof(sim_dma2_stream2));
+	memset(&sim_dma2_stream5, 0, sizeof(sim_dma2_stream5));
+	for(uint8_t i=0; i<2; i++)
+	{
+		sim_dma[i].enabled = false;
+	}
+	memset(sim_sensors, 0, sizeof(sim_sensors));
+	sim_sensor_count = 0;
+	sim_scenario = scenario;
+	sim_seed = seed ? seed : 1;
+	sim_htim = NULL;
+	sim_ic_dma = NULL;
+	sim_pending_ic = false;
+	memset(sim_pending_cc, 0, sizeof(sim_pending_cc));
+	sim_tim_psc_count = 0;
+	//Line idles HIGH through the pull-up
+	sim_gpioa.IDR = 0xFFFF;
+	sim_gpiob.IDR = 0xFFFF;
+}
+
+sim_sensor_t *sim_add_sensor(GPIO_TypeDef *port, uint16_t pin)
+{
+	sim_sensor_t *s = &sim_sensors[sim_sensor_count++];
+
+	s->port = port;
+	s->pin = pin;
+	s->level = 1;
+	return s;
+}
+
+void sim_attach_timer(TIM_HandleTypeDef *htim, GPIO_TypeDef *port, uint16_t pin)
+{
+	sim_htim = htim;
+	sim_ic_port = port;
+	sim_ic_pin = pin;
+	sim_ic_level = 1;
+	//Mirrors MX_TIM1_Init(): 1MHz tick, free running
+	htim->Instance = &sim_tim1;
+	sim_tim1.PSC = 25-1;
+	sim_tim1.ARR = 65535;
+}
+
+bool sim_load_recording(const char *path, int16_t *temp_x10, uint16_t *humid_x10, bool *has_truth)
+{
+	FILE *f = fopen(path, "r");
+	char line[128];
+	float t, h;
+	unsigned us;
+	int n;
+
+	if(f == NULL) return false;
+	sim_recording_count = 0;
+	*has_truth = false;
+	while(fgets(line, sizeof(line), f) != NULL)
+	{
+		if(sscanf(line, "# expect %f %f", &t, &h) == 2)
+		{
+			*temp_x10 = (int16_t)(t*10 + (t < 0 ? -0.5f : 0.5f));
+			*humid_x10 = (uint16_t)(h*10 + 0.5f);
+			*has_truth = true;
+			continue;
+		}
+		if(line[0] == '#') continue;
+		for(char *p = line; sscanf(p, "%u%n", &us, &n) == 1 && sim_recording_count < SIM_MAX_SEGMENTS; p += n)
+		{
+			sim_recording[sim_recording_count++] = us;
+		}
+	}
+	fclose(f);
+	return sim_recording_count != 0;
+}
+
+//*** HAL functions used by the driver ***//
+
+uint32_t HAL_GetTick(void)
+{
+	return (uint32_t)(sim_now / (SIM_CORE_HZ/1000));
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+	for(uint8_t i=0; i<16; i++)
+	{
+		if(!(GPIO_Init->Pin & (1U << i))) continue;
+		GPIOx->MODER = (GPIOx->MODER & ~(3UL << 2*i)) | ((GPIO_Init->Mode & 3UL) << 2*i);
+		if(GPIO_Init->Mode & OUTPUT_TYPE) GPIOx->OTYPER |= 1UL << i;
+		else if((GPIO_Init->Mode & 3UL) != 0) GPIOx->OTYPER &= ~(1UL << i);
+	}
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+	sim_dma_t *dma = sim_dma_find(hdma->Instance);
+
+	if(dma == NULL || dma->enabled) return HAL_BUSY;
+	//Addresses fit 32 bits because the bench is linked without PIE
+	dma->src = (volatile uint32_t *)(uintptr_t)SrcAddress;
+	dma->dst = (uint16_t *)(uintptr_t)DstAddress;
+	dma->regs->NDTR = DataLength;
+	dma->regs->CR |= DMA_SxCR_EN;
+	dma->enabled = true;
+	hdma->State = HAL_DMA_STATE_BUSY;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+	sim_dma_t *dma = sim_dma_find(hdma->Instance);
+
+	if(dma == NULL) return HAL_ERROR;
+	dma->enabled = false;
+	dma->regs->CR &= ~DMA_SxCR_EN;
+	hdma->State = HAL_DMA_STATE_READY;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start_DMA(TIM_HandleTypeDef *htim, uint32_t Channel, uint32_t *pData, uint16_t Length)
+{
+	sim_dma_t *dma = sim_dma_find(htim->hdma[TIM_DMA_ID_CC1 + Channel/4]->Instance);
+
+	if(dma == NULL || dma->enabled) return HAL_BUSY;
+	sim_ic_channel = Channel;
+	sim_ic_dma = dma;
+	sim_ic_level = (sim_ic_port->IDR & sim_ic_pin) != 0;
+	sim_ic_filter_count = 0;
+	dma->dst = (uint16_t *)pData;
+	dma->regs->NDTR = Length;
+	dma->regs->CR |= DMA_SxCR_EN;
+	dma->enabled = true;
+	htim->Instance->CCER |= 1UL << Channel;
+	htim->Instance->DIER |= TIM_DIER_CC1DE << (Channel/4);
+	htim->Instance->CR1 |= TIM_CR1_CEN;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Stop_DMA(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+	sim_dma_t *dma = sim_dma_find(htim->hdma[TIM_DMA_ID_CC1 + Channel/4]->Instance);
+
+	htim->Instance->CCER &= ~(1UL << Channel);
+	htim->Instance->DIER &= ~(TIM_DIER_CC1DE << (Channel/4));
+	if(dma != NULL)
+	{
+		dma->enabled = false;
+		dma->regs->CR &= ~DMA_SxCR_EN;
+	}
+	//Like __HAL_TIM_DISABLE(): counter stops once no channel is enabled
+	if(!(htim->Instance->CCER & (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E)))
+	{
+		htim->Instance->CR1 &= ~TIM_CR1_CEN;
+	}
+	return HAL_OK;
+}
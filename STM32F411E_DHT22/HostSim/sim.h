@@ -0,0 +1,88 @@
+/*
+ * Host simulator for the DHT22 driver: simulated GPIO ports, TIM1, DMA2 streams and DHT22 sensors.
+ *
+ * Time only moves when the driver touches the cycle counter (busy time), sleeps in __WFI() or the test bench
+ * idles the main loop (free time). The simulation is stepped one core clock cycle at a time, so every
+ * sensor waveform, pin level, timer tick, input filter and DMA request is resolved at 40nSec (25MHz SYSCLK).
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include "stm32f4xx_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+//Clock tree of the target project: SYSCLK 25MHz, TIM1 prescaler 25-1 -> 1MHz
+#define SIM_CORE_HZ						25000000UL
+#define SIM_CYCLES_PER_US			25
+
+//Cost model of the CPU time spent in the driver
+#define SIM_POLL_CYCLES				8			//One iteration of a cycle counter polling loop
+#define SIM_ISR_CYCLES				120		//Interrupt entry/exit and HAL IRQ handler dispatch
+
+//Sensor model
+#define SIM_MAX_SENSORS				16
+#define SIM_MAX_SEGMENTS			128		//Line levels of one frame, glitches included
+#define SIM_WAKE_US						200		//Host LOW time the sensor needs to start a frame
+#define SIM_IC_FILTER_CYCLES	8			//TIM1 input filter 3: fCK_INT, N=8
+
+//Waveform impairments
+typedef struct
+{
+	const char *name;
+	uint32_t jitter_ns;						//Uniform +- on every level of the frame
+	uint32_t glitch_pct;					//Chance per bit of a short LOW spike in its HIGH time
+	uint32_t glitch_ns;						//Longest spike, shortest is a quarter of it
+	uint32_t rise_ns;							//Time a released line takes to reach VIH
+	uint32_t bad_checksum_pct;		//Chance of a corrupted checksum byte
+	bool absent;									//No sensor on the line
+}sim_scenario_t;
+
+//One simulated sensor and the truth of the last frame it sent
+typedef struct
+{
+	GPIO_TypeDef *port;
+	uint16_t pin;
+	//Truth
+	int16_t temp_x10;
+	uint16_t humid_x10;
+	bool checksum_ok;
+	uint32_t frames;
+	//Line model
+	uint32_t host_low_cycles;
+	bool sending;
+	uint8_t seg_level[SIM_MAX_SEGMENTS];
+	uint32_t seg_cycles[SIM_MAX_SEGMENTS];
+	uint16_t seg_count, seg_idx;
+	uint32_t seg_left;
+	bool level;
+	uint32_t rise_left;
+}sim_sensor_t;
+
+//Simulated peripherals (peripheral handles point their Instance here)
+extern GPIO_TypeDef sim_gpioa, sim_gpiob;
+extern TIM_TypeDef sim_tim1;
+extern DMA_Stream_TypeDef sim_dma2_stream2, sim_dma2_stream5;
+
+//Clock and accounting
+extern uint64_t sim_now;								//Core cycles since reset
+extern uint64_t sim_busy_cycles;				//Cycles the CPU spent busy in the driver or its interrupts
+extern uint32_t sim_isr_count;
+
+//Reset time, peripherals and sensors, select the waveform impairments
+void sim_reset(const sim_scenario_t *scenario, uint32_t seed);
+//Attach a sensor model to a pin
+sim_sensor_t *sim_add_sensor(GPIO_TypeDef *port, uint16_t pin);
+//Timer whose interrupts are dispatched to the HAL callbacks, and the pin wired to its capture channel
+void sim_attach_timer(TIM_HandleTypeDef *htim, GPIO_TypeDef *port, uint16_t pin);
+//Replay a recorded frame instead of synthetic ones, returns false if the file cannot be read
+bool sim_load_recording(const char *path, int16_t *temp_x10, uint16_t *humid_x10, bool *has_truth);
+//Advance time, busy or free CPU
+void sim_step(uint32_t cycles, bool busy);
+void sim_idle(uint32_t cycles);
+
+//Pseudo random numbers, deterministic per seed
+uint32_t sim_rand(void);
+
+#endif
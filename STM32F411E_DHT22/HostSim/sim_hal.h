@@ -0,0 +1,17 @@
+/*
+ * Host simulator: core peripheral hooks used by the stm32f411xe.h shim.
+ * Only device header types may be used here, the HAL is not included yet at this point.
+ */
+
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+//Cycle counter access, advances the simulated clock by one poll iteration
+DWT_Type *sim_dwt(void);
+//Sleep until the next interrupt or SysTick
+void sim_wfi(void);
+
+extern CoreDebug_Type sim_core_debug;
+extern DMA_TypeDef sim_dma_status;
+
+#endif
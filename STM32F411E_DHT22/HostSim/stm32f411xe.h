@@ -0,0 +1,38 @@
+/*
+ * Host simulator shim for the device header.
+ *
+ * Found ahead of the CMSIS device include directory, so every source that includes "stm32f411xe.h" by name
+ * (hal_dwt_delay.h, and through it MY_DHT22.c) gets the real register definitions followed by the simulator
+ * hooks below. Core peripherals at fixed addresses are redirected to simulated registers, and every cycle
+ * counter access advances the simulated clock, which is what moves the waveforms on the pins.
+ */
+
+#include_next "stm32f411xe.h"
+
+#ifndef SIM_STM32F411XE_HOOKS_H
+#define SIM_STM32F411XE_HOOKS_H
+
+#include "sim_hal.h"
+
+#undef DWT
+#define DWT                 (sim_dwt())
+
+#undef CoreDebug
+#define CoreDebug           (&sim_core_debug)
+
+/* DMA interrupt status registers read by __HAL_DMA_GET_FLAG(), the simulated streams never set an error flag */
+#undef DMA1
+#define DMA1                (&sim_dma_status)
+#undef DMA2
+#define DMA2                (&sim_dma_status)
+
+#undef __WFI
+#define __WFI()             sim_wfi()
+
+/* Interrupts are only dispatched from inside the simulated clock, masking is a no-op */
+#define __disable_irq()     ((void)0)
+#define __enable_irq()      ((void)0)
+#define __get_PRIMASK()     (0U)
+#define __set_PRIMASK(x)    ((void)(x))
+
+#endif
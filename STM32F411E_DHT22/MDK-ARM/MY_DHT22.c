@@ -27,153 +27,918 @@ References:				This library was written based on the DHT22 datasheet
 #define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
 #define bitWrite(value, bit, bitvalue) (bitvalue ? bitSet(value, bit) : bitClear(value, bit))
 
-//1. One wire data line
-static GPIO_TypeDef* oneWire_PORT;
-static uint16_t oneWire_PIN;
-static uint8_t oneWirePin_Idx;
+//Sensor that currently owns the capture timer, NULL when free
+static DHT22_HandleTypeDef *timActive;
+//Bus scan that currently owns the sampling timer, NULL when free
+static DHT22_Bus_Typedef *busActive;
+
+//*** Private functions prototypes ***//
+//Change pin mode
+static void ONE_WIRE_PinMode(DHT22_HandleTypeDef *hdht, OnePinMode_Typedef mode);
+//One Wire pin HIGH/LOW Write
+static void ONE_WIRE_Pin_Write(DHT22_HandleTypeDef *hdht, bool state);
+static bool ONE_WIRE_Pin_Read(DHT22_HandleTypeDef *hdht);
+//Wait for line level with a time budget
+static bool ONE_WIRE_WaitLevel(DHT22_HandleTypeDef *hdht, bool level, uint32_t uSec);
+//Microsecond delay
+static void DelayMicroSeconds(uint32_t uSec);
+//Begin function
+static void DHT22_StartAcquisition(DHT22_HandleTypeDef *hdht);
+//Read 5 bytes
+static DHT22_Status_Typedef DHT22_ReadRaw(DHT22_HandleTypeDef *hdht, uint8_t *data);
+//Checksum, sign-magnitude unpack and range check of 5 raw bytes
+static DHT22_Status_Typedef DHT22_Unpack(const uint8_t *data, int16_t *TempX10, uint16_t *HumidityX10);
+//Change between two good readings is within the rate limits
+static bool DHT22_RateOk(const DHT22_Rate_Typedef *rate, int16_t prevTemp, uint16_t prevHumidity, int16_t Temp, uint16_t Humidity, uint32_t elapsedMs);
+//Validate 5 raw bytes against the sensor limits and the last good reading
+static DHT22_Status_Typedef DHT22_Convert(DHT22_HandleTypeDef *hdht, uint8_t *data);
+//Decode a full set of falling edge timestamps
+static DHT22_Status_Typedef DHT22_DecodeEdges(DHT22_HandleTypeDef *hdht);
+//Classify a frame that stopped after `captured` edges
+static DHT22_Status_Typedef DHT22_EdgesMissing(DHT22_HandleTypeDef *hdht, uint16_t captured);
+//Count a finished read
+static DHT22_Status_Typedef DHT22_Record(DHT22_HandleTypeDef *hdht, DHT22_Status_Typedef status);
+//Store result of a non-blocking read and notify the application
+static void DHT22_Complete(DHT22_HandleTypeDef *hdht, DHT22_Status_Typedef status);
+//Release line and arm capture at the end of the start pulse
+static bool DHT22_IC_Arm(DHT22_HandleTypeDef *hdht);
+//Abort a capture that ran out of time and classify the failure
+static DHT22_Status_Typedef DHT22_IC_Timeout(DHT22_HandleTypeDef *hdht);
+//Program the compare channel
+static void DHT22_Async_Schedule(DHT22_HandleTypeDef *hdht, uint32_t uSec);
+//Finish the running acquisition
+static void DHT22_Async_Finish(DHT22_HandleTypeDef *hdht, DHT22_Status_Typedef status);
+//Pull all pending sensors of the next port low
+static void DHT22_Bus_StartPort(DHT22_Bus_Typedef *bus);
+//Decode every sensor of the sampled port
+static void DHT22_Bus_DecodePort(DHT22_Bus_Typedef *bus);
+//Fail every pending sensor of the sampled port
+static void DHT22_Bus_FailPort(DHT22_Bus_Typedef *bus, DHT22_Status_Typedef status);
 
 //*** Functions prototypes ***//
 //OneWire Initialise
-void DHT22_Init(GPIO_TypeDef* DataPort, uint16_t DataPin)
+void DHT22_Init(DHT22_HandleTypeDef *hdht, GPIO_TypeDef* DataPort, uint16_t DataPin)
 {
-	oneWire_PORT = DataPort;
-	oneWire_PIN = DataPin;
-	
-
+	GPIO_InitTypeDef GPIO_InitStruct;
 	
+	memset(hdht, 0, sizeof(*hdht));
+	hdht->Port = DataPort;
+	hdht->Pin = DataPin;
+	hdht->FailedBit = -1;
+	hdht->StaleMs = DHT22_MIN_INTERVAL_MS;
+	hdht->Rate.TempX10 = DHT22_TEMP_RATE_X10;
+	hdht->Rate.HumidityX10 = DHT22_HUMIDITY_RATE_X10;
+	//Cycle counter timebase for the microsecond delays
+	hal_dwt_init();
 	
 	for(uint8_t i=0; i<16; i++)
 	{
 		if(DataPin & (1 << i))
 		{
-			oneWirePin_Idx = i;
+			hdht->PinIdx = i;
 			break;
 		}
 	}
-
+	//MODER field of the pin, so a direction change is a single register write
+	hdht->ModerMask = 3UL << 2*hdht->PinIdx;
+	hdht->ModerOutput = 1UL << 2*hdht->PinIdx;
+	hdht->ModerAF = 2UL << 2*hdht->PinIdx;
 	
+	//Speed, pull and output type are configured once, line released
+	GPIO_InitStruct.Pin = DataPin;
+	GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	HAL_GPIO_Init(DataPort, &GPIO_InitStruct);
+}
+
+//Open-drain line: LOW is driven, HIGH releases to the pull-up and IDR follows the sensor
+void DHT22_SetOpenDrain(DHT22_HandleTypeDef *hdht, bool enable)
+{
+	hdht->OpenDrain = enable;
+	if(enable)
+	{
+		hdht->Port->OTYPER |= hdht->Pin;
+	}
+	else
+	{
+		hdht->Port->OTYPER &= ~hdht->Pin;
+	}
+	ONE_WIRE_PinMode(hdht, ONE_INPUT);
 }
+
+//Largest plausible change per second (0.1C/s, 0.1%RH/s) between good readings, 0 disables the check
+void DHT22_SetRateLimit(DHT22_HandleTypeDef *hdht, uint16_t TempX10, uint16_t HumidityX10)
+{
+	hdht->Rate.TempX10 = TempX10;
+	hdht->Rate.HumidityX10 = HumidityX10;
+}
+
 //Change pin mode
-static void ONE_WIRE_PinMode(OnePinMode_Typedef mode)
+static void ONE_WIRE_PinMode(DHT22_HandleTypeDef *hdht, OnePinMode_Typedef mode)
 {
-	GPIO_InitTypeDef GPIO_InitStruct;
-	GPIO_InitStruct.Pin = oneWire_PIN;
-	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	uint32_t moder = hdht->Port->MODER & ~hdht->ModerMask;
 	
 	if(mode == ONE_OUTPUT)
 	{
-//		oneWire_PORT->MODER &= ~(3UL << 2*oneWirePin_Idx);  //Reset State
-//		oneWire_PORT->MODER |= (0x01 << 2*oneWirePin_Idx); //Output Mode
-		GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+		moder |= hdht->ModerOutput;
 	}
 	else if(mode == ONE_INPUT)
 	{
-//		oneWire_PORT->MODER &= ~(3UL << 2*oneWirePin_Idx);  //Input Mode
-		GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+		//Open-drain line is released by driving it HIGH, it stays an output
+		if(hdht->OpenDrain)
+		{
+			hal_gpio_set_pins(hdht->Port, hdht->Pin);
+			moder |= hdht->ModerOutput;
+		}
+	}
+	else if(mode == ONE_CAPTURE)
+	{
+		//Timer channel owns the pin, line is released to the pull-up (AFR set in DHT22_IC_Init)
+		moder |= hdht->ModerAF;
 	}
 	
-	HAL_GPIO_Init(oneWire_PORT, &GPIO_InitStruct);
+	hdht->Port->MODER = moder;
 }	
 //One Wire pin HIGH/LOW Write
-static void ONE_WIRE_Pin_Write(bool state)
+static void ONE_WIRE_Pin_Write(DHT22_HandleTypeDef *hdht, bool state)
 {
-	if(state) HAL_GPIO_WritePin(oneWire_PORT, oneWire_PIN, GPIO_PIN_SET);
-	else HAL_GPIO_WritePin(oneWire_PORT, oneWire_PIN, GPIO_PIN_RESET);
+	hal_gpio_write_pins(hdht->Port, hdht->Pin, state ? hdht->Pin : 0);
 }
-static bool ONE_WIRE_Pin_Read(void)
+static bool ONE_WIRE_Pin_Read(DHT22_HandleTypeDef *hdht)
 {
-	return (1&HAL_GPIO_ReadPin(oneWire_PORT, oneWire_PIN));
+	return hal_gpio_read_pins(hdht->Port, hdht->Pin) != 0;
 }
 
-//Microsecond delay
+//Wait for line level with a time budget
+static bool ONE_WIRE_WaitLevel(DHT22_HandleTypeDef *hdht, bool level, uint32_t uSec)
+{
+	hal_dwt_deadline_t deadline;
+	
+	hal_dwt_deadline_set(&deadline, uSec);
+	while(ONE_WIRE_Pin_Read(hdht) != level)
+	{
+		if(hal_dwt_deadline_expired(&deadline)) return 0;
+	}
+	return 1;
+}
+
+//Microsecond delay, exact at any clock or optimisation level
 static void DelayMicroSeconds(uint32_t uSec)
 {
-	uint32_t uSecVar = uSec;
-	uSecVar = uSecVar* ((SystemCoreClock/1000000)/3);
-	while(uSecVar--);
+	hal_dwt_delay_us(uSec);
 }
 
 //DHT Begin function
-static void DHT22_StartAcquisition(void)
+static void DHT22_StartAcquisition(DHT22_HandleTypeDef *hdht)
 {
+	hdht->LastStartTick = HAL_GetTick();
 	//Change data pin mode to OUTPUT
-	ONE_WIRE_PinMode(ONE_OUTPUT);
+	ONE_WIRE_PinMode(hdht, ONE_OUTPUT);
 	//Put pin LOW
-	ONE_WIRE_Pin_Write(0);
+	ONE_WIRE_Pin_Write(hdht, 0);
 	//500uSec delay
-	DelayMicroSeconds(500);
+	DelayMicroSeconds(DHT22_START_LOW_US);
 	//Bring pin HIGH
-	ONE_WIRE_Pin_Write(1);
+	ONE_WIRE_Pin_Write(hdht, 1);
 	//30 uSec delay
 	DelayMicroSeconds(30);
 	//Set pin as input
-	ONE_WIRE_PinMode(ONE_INPUT);
+	ONE_WIRE_PinMode(hdht, ONE_INPUT);
 }
 //Read 5 bytes
-static void DHT22_ReadRaw(uint8_t *data)
+static DHT22_Status_Typedef DHT22_ReadRaw(DHT22_HandleTypeDef *hdht, uint8_t *data)
 {
-	uint32_t rawBits = 0UL;
-	uint8_t checksumBits=0;
+	uint32_t highStart;
+	uint32_t bitThreshold = hal_dwt_us_to_cycles(DHT22_BIT_THRESHOLD_US);
+	
+	memset(data, 0, 5);
+	//Sensor response: ~80uSec LOW, ~80uSec HIGH, then LOW for the start of bit 0
+	if(!ONE_WIRE_WaitLevel(hdht, 0, DHT22_EDGE_TIMEOUT_US)) return DHT22_ERR_NO_RESPONSE;
+	if(!ONE_WIRE_WaitLevel(hdht, 1, DHT22_EDGE_TIMEOUT_US)) return DHT22_ERR_NO_RESPONSE;
+	if(!ONE_WIRE_WaitLevel(hdht, 0, DHT22_EDGE_TIMEOUT_US)) return DHT22_ERR_NO_RESPONSE;
 	
-	DelayMicroSeconds(40);
-	while(!ONE_WIRE_Pin_Read());
-	while(ONE_WIRE_Pin_Read());
-	for(int8_t i=31; i>=0; i--)
+	for(uint8_t i=0; i<40; i++)
 	{
-		while(!ONE_WIRE_Pin_Read());
-		DelayMicroSeconds(40);
-		if(ONE_WIRE_Pin_Read())
+		//~50uSec LOW, then HIGH for ~26uSec (0) or ~70uSec (1)
+		hdht->FailedBit = i;
+		if(!ONE_WIRE_WaitLevel(hdht, 1, DHT22_EDGE_TIMEOUT_US)) return DHT22_ERR_TIMEOUT;
+		highStart = hal_dwt_get_cycles();
+		if(!ONE_WIRE_WaitLevel(hdht, 0, DHT22_EDGE_TIMEOUT_US)) return DHT22_ERR_TIMEOUT;
+		if((hal_dwt_get_cycles() - highStart) > bitThreshold)
 		{
-			rawBits |= (1UL << i);
+			data[i/8] |= (0x80 >> (i%8));
 		}
-		while(ONE_WIRE_Pin_Read());
 	}
+	hdht->FailedBit = -1;
+	return DHT22_OK;
+}
+
+//Checksum, sign-magnitude unpack and range check of 5 raw bytes (values are unpacked even when invalid)
+static DHT22_Status_Typedef DHT22_Unpack(const uint8_t *data, int16_t *TempX10, uint16_t *HumidityX10)
+{
+	uint8_t myChecksum;
+	uint16_t Temp16;
+	
+	*HumidityX10 = (data[0] <<8) | data[1];
+	//Temperature bit 15 is the sign, bits 14-0 the magnitude
+	Temp16 = ((data[2] & 0x7F) <<8) | data[3];
+	*TempX10 = (data[2] & 0x80) ? -(int16_t)Temp16 : (int16_t)Temp16;
+	
+	//calculate checksum
+	myChecksum = 0;
+	for(uint8_t k=0; k<4; k++) 
+	{
+		myChecksum += data[k];
+	}
+	if(myChecksum != data[4]) return DHT22_ERR_CHECKSUM;
+	if(*TempX10 < DHT22_TEMP_MIN_X10 || *TempX10 > DHT22_TEMP_MAX_X10 || *HumidityX10 > DHT22_HUMIDITY_MAX_X10) return DHT22_ERR_RANGE;
+	return DHT22_OK;
+}
+
+//Change from the previous good reading, elapsedMs earlier, is within the rate limits
+static bool DHT22_RateOk(const DHT22_Rate_Typedef *rate, int16_t prevTemp, uint16_t prevHumidity, int16_t Temp, uint16_t Humidity, uint32_t elapsedMs)
+{
+	uint32_t tempStep = (Temp > prevTemp) ? Temp - prevTemp : prevTemp - Temp;
+	uint32_t humidStep = (Humidity > prevHumidity) ? Humidity - prevHumidity : prevHumidity - Humidity;
+	
+	//After a minute any change of the sensor range is plausible, this also keeps the products in 32 bits
+	if(elapsedMs > 0xFFFF) return 1;
+	//One count of slack for the sensor's own rounding
+	if(rate->TempX10 != 0 && tempStep > rate->TempX10*elapsedMs/1000 + 1) return 0;
+	if(rate->HumidityX10 != 0 && humidStep > rate->HumidityX10*elapsedMs/1000 + 1) return 0;
+	return 1;
+}
+
+//Validate 5 raw bytes against the sensor limits and the last good reading, result in hdht->TempX10/HumidityX10
+static DHT22_Status_Typedef DHT22_Convert(DHT22_HandleTypeDef *hdht, uint8_t *data)
+{
+	int16_t TempX10;
+	uint16_t HumidityX10;
+	DHT22_Status_Typedef status = DHT22_Unpack(data, &TempX10, &HumidityX10);
+	
+	if(status != DHT22_OK) return status;
+	if((hdht->Cache.Flags & DHT22_SAMPLE_VALID) &&
+		 !DHT22_RateOk(&hdht->Rate, hdht->Cache.TempX10, hdht->Cache.HumidityX10, TempX10, HumidityX10, HAL_GetTick() - hdht->Cache.Tick))
+	{
+		return DHT22_ERR_RATE;
+	}
+	hdht->TempX10 = TempX10;
+	hdht->HumidityX10 = HumidityX10;
+	return DHT22_OK;
+}
+
+//Decode a full set of falling edge timestamps
+static DHT22_Status_Typedef DHT22_DecodeEdges(DHT22_HandleTypeDef *hdht)
+{
+	uint8_t dataArray[5] = {0};
+	uint16_t width;
 	
-	for(int8_t i=7; i>=0; i--)
+	//Edge 0 is the sensor response, edge 1 starts bit 0; bit i ends at edge i+2
+	for(uint8_t i=0; i<40; i++)
 	{
-		while(!ONE_WIRE_Pin_Read());
-		DelayMicroSeconds(40);
-		if(ONE_WIRE_Pin_Read())
+		width = (uint16_t)(hdht->Edges[i+2] - hdht->Edges[i+1]);
+		if(width > DHT22_IC_MAX_PERIOD)
 		{
-			checksumBits |= (1UL << i);
+			hdht->FailedBit = i;
+			return DHT22_ERR_TIMEOUT;
+		}
+		if(width > DHT22_IC_BIT_THRESHOLD)
+		{
+			dataArray[i/8] |= (0x80 >> (i%8));
 		}
-		while(ONE_WIRE_Pin_Read());
 	}
+	return DHT22_Convert(hdht, dataArray);
+}
+
+//Classify a frame that stopped after `captured` edges
+static DHT22_Status_Typedef DHT22_EdgesMissing(DHT22_HandleTypeDef *hdht, uint16_t captured)
+{
+	if(captured < 2) return DHT22_ERR_NO_RESPONSE;
+	hdht->FailedBit = captured - 2;
+	return DHT22_ERR_TIMEOUT;
+}
+
+//Count a finished read and update the sample cache (result is in hdht->TempX10/HumidityX10)
+static DHT22_Status_Typedef DHT22_Record(DHT22_HandleTypeDef *hdht, DHT22_Status_Typedef status)
+{
+	//Only a mid-frame timeout has a meaningful bit index
+	if(status != DHT22_ERR_TIMEOUT) hdht->FailedBit = -1;
+	hdht->Stats.Count[status]++;
 	
-	
-	//Copy raw data to array of bytes
-	data[0] = (rawBits>>24)&0xFF;
-	data[1] = (rawBits>>16)&0xFF;
-	data[2] = (rawBits>>8)&0xFF;
-	data[3] = (rawBits>>0)&0xFF;
-	data[4] = (checksumBits)&0xFF;
+	hdht->Cache.LastStatus = status;
+	if(status == DHT22_OK)
+	{
+		hdht->Cache.TempX10 = hdht->TempX10;
+		hdht->Cache.HumidityX10 = hdht->HumidityX10;
+		hdht->Cache.Tick = HAL_GetTick();
+		hdht->Cache.Flags = DHT22_SAMPLE_VALID;
+	}
+	else
+	{
+		hdht->Cache.Flags |= DHT22_SAMPLE_FAILED;
+	}
+	return status;
 }
 
-//Get Temperature and Humidity data
-bool DHT22_GetTemp_Humidity(float *Temp, float *Humidity)
+//Store result of a non-blocking read and notify the application
+static void DHT22_Complete(DHT22_HandleTypeDef *hdht, DHT22_Status_Typedef status)
+{
+	hdht->Status = DHT22_Record(hdht, status);
+	hdht->State = (status == DHT22_OK) ? DHT22_DONE : DHT22_ERROR;
+	if(hdht->Callback != NULL)
+	{
+		hdht->Callback(hdht, status, hdht->TempX10/10.0f, hdht->HumidityX10/10.0f);
+	}
+}
+
+//Read Temperature (0.1C) and Humidity (0.1%RH), every wait is bounded
+DHT22_Status_Typedef DHT22_ReadX10(DHT22_HandleTypeDef *hdht, int16_t *TempX10, uint16_t *HumidityX10)
 {
-	uint8_t dataArray[6], myChecksum;
-	uint16_t Temp16, Humid16;
+	uint8_t dataArray[6];
+	DHT22_Status_Typedef status;
 	//Implement Start data Aqcuisition routine
-	DHT22_StartAcquisition();
+	DHT22_StartAcquisition(hdht);
 	//Aqcuire raw data
-	DHT22_ReadRaw(dataArray);
-	//calculate checksum
-	myChecksum = 0;
-	for(uint8_t k=0; k<4; k++) 
+	status = DHT22_ReadRaw(hdht, dataArray);
+	//Checksum and convert
+	if(status == DHT22_OK) status = DHT22_Convert(hdht, dataArray);
+	if(status == DHT22_OK)
 	{
-		myChecksum += dataArray[k];
+		*TempX10 = hdht->TempX10;
+		*HumidityX10 = hdht->HumidityX10;
 	}
-	if(myChecksum == dataArray[4])
+	return DHT22_Record(hdht, status);
+}
+
+//Read Temperature and Humidity, every wait is bounded
+DHT22_Status_Typedef DHT22_Read(DHT22_HandleTypeDef *hdht, float *Temp, float *Humidity)
+{
+	int16_t TempX10;
+	uint16_t HumidityX10;
+	DHT22_Status_Typedef status = DHT22_ReadX10(hdht, &TempX10, &HumidityX10);
+	
+	if(status == DHT22_OK)
 	{
-		Temp16 = (dataArray[2] <<8) | dataArray[3];
-		Humid16 = (dataArray[0] <<8) | dataArray[1];
+		*Temp = TempX10/10.0f;
+		*Humidity = HumidityX10/10.0f;
+	}
+	return status;
+}
+
+//Get Temperature and Humidity data
+bool DHT22_GetTemp_Humidity(DHT22_HandleTypeDef *hdht, float *Temp, float *Humidity)
+{
+	return DHT22_Read(hdht, Temp, Humidity) == DHT22_OK;
+}
+
+//Bit index (0-39) at which the last TIMEOUT occurred, -1 if none
+int8_t DHT22_GetFailedBit(DHT22_HandleTypeDef *hdht)
+{
+	return hdht->FailedBit;
+}
+
+//Failure mode counters
+const DHT22_Stats_Typedef *DHT22_GetStats(DHT22_HandleTypeDef *hdht)
+{
+	return &hdht->Stats;
+}
+
+//Printable status name
+const char *DHT22_StatusString(DHT22_Status_Typedef status)
+{
+	switch(status)
+	{
+		case DHT22_OK:							return "OK";
+		case DHT22_ERR_NO_RESPONSE:	return "NO_RESPONSE";
+		case DHT22_ERR_TIMEOUT:			return "TIMEOUT";
+		case DHT22_ERR_CHECKSUM:		return "CHECKSUM";
+		case DHT22_ERR_RANGE:				return "RANGE";
+		case DHT22_ERR_RATE:				return "RATE";
+		case DHT22_BUSY:						return "BUSY";
+		default:										return "?";
+	}
+}
+
+//*** Batch decode ***//
+//Frames are checked one by one (checksum, sign, range and rate against the previous good frame), then
+//the whole batch is clipped to the sensor limits and scaled with the CMSIS-DSP block kernels.
+uint16_t DHT22_DecodeBatch(const DHT22_Batch_Typedef *batch, const uint8_t *frames, uint16_t count,
+													 q15_t *TempOut, q15_t *HumidityOut, DHT22_Status_Typedef *status)
+{
+	int16_t prevTemp = 0;
+	uint16_t prevHumidity = 0, humidity, good = 0;
+	uint32_t elapsedMs = 0;
+	
+	for(uint16_t i=0; i<count; i++)
+	{
+		status[i] = DHT22_Unpack(&frames[5*i], &TempOut[i], &humidity);
+		HumidityOut[i] = (q15_t)humidity;
+		elapsedMs += batch->PeriodMs;
+		if(status[i] == DHT22_OK && good != 0 &&
+			 !DHT22_RateOk(&batch->Rate, prevTemp, prevHumidity, TempOut[i], humidity, elapsedMs))
+		{
+			status[i] = DHT22_ERR_RATE;
+		}
+		if(status[i] == DHT22_OK)
+		{
+			prevTemp = TempOut[i];
+			prevHumidity = humidity;
+			elapsedMs = 0;
+			good++;
+		}
+	}
+	//Rejected frames still hold a value, keep every output inside the sensor range
+	arm_clip_q15(TempOut, TempOut, DHT22_TEMP_MIN_X10, DHT22_TEMP_MAX_X10, count);
+	arm_clip_q15(HumidityOut, HumidityOut, 0, DHT22_HUMIDITY_MAX_X10, count);
+	//Convert to the caller's units
+	arm_scale_q15(TempOut, batch->ScaleFract, batch->Shift, TempOut, count);
+	arm_scale_q15(HumidityOut, batch->ScaleFract, batch->Shift, HumidityOut, count);
+	return good;
+}
+
+//*** Sample cache ***//
+//Every finished read, whatever the backend, lands in hdht->Cache via DHT22_Record().
+//Consumers get the last good sample in microseconds; a stale cache starts an async
+//refresh, never earlier than DHT22_MIN_INTERVAL_MS after the previous start pulse
+//(LastStartTick starts at 0, which also gives the sensor time to settle after power-up).
+
+//Keep readings for StaleMs before refreshing
+void DHT22_Cache_Init(DHT22_HandleTypeDef *hdht, uint32_t StaleMs)
+{
+	hdht->StaleMs = (StaleMs < DHT22_MIN_INTERVAL_MS) ? DHT22_MIN_INTERVAL_MS : StaleMs;
+}
+
+//Last good sample with age and flags
+bool DHT22_Cache_Get(DHT22_HandleTypeDef *hdht, DHT22_Sample_Typedef *sample)
+{
+	uint32_t now = HAL_GetTick();
+	uint32_t primask = __get_PRIMASK();
+	
+	//The cache is written from the capture interrupt, copy it in one piece
+	__disable_irq();
+	*sample = hdht->Cache;
+	__set_PRIMASK(primask);
+	
+	sample->AgeMs = now - sample->Tick;
+	if(!(sample->Flags & DHT22_SAMPLE_VALID) || sample->AgeMs >= hdht->StaleMs)
+	{
+		sample->Flags |= DHT22_SAMPLE_STALE;
+	}
+	
+	if(hdht->State == DHT22_START_LOW || hdht->State == DHT22_CAPTURING)
+	{
+		sample->Flags |= DHT22_SAMPLE_REFRESHING;
+	}
+	//Background refresh needs the async backend, bus sensors are refreshed by their scan
+	else if((sample->Flags & DHT22_SAMPLE_STALE) && hdht->htim != NULL && hdht->CompareIT != 0 && (now - hdht->LastStartTick) >= DHT22_MIN_INTERVAL_MS)
+	{
+		if(DHT22_Async_Start(hdht, hdht->Callback)) sample->Flags |= DHT22_SAMPLE_REFRESHING;
+	}
+	return (sample->Flags & DHT22_SAMPLE_VALID) != 0;
+}
+
+//*** Input capture + DMA backend ***//
+//The timer latches CNT on every falling edge of the line and DMA streams the
+//captures into hdht->Edges[], so the CPU is free while the ~5mSec frame arrives.
+//Bit values are recovered afterwards from the spacing of consecutive edges.
+//One capture runs per timer at a time; the sensor holding it is timActive.
+
+//Attach timer channel wired to the data pin
+void DHT22_IC_Init(DHT22_HandleTypeDef *hdht, TIM_HandleTypeDef *htim, uint32_t Channel, uint32_t Alternate)
+{
+	hdht->htim = htim;
+	hdht->Channel = Channel;
+	hdht->Alternate = Alternate;
+	hdht->IcComplete = false;
+	//Alternate function is selected once, ONE_CAPTURE then only switches MODER
+	hdht->Port->AFR[hdht->PinIdx >> 3] &= ~(0xFUL << 4*(hdht->PinIdx & 7));
+	hdht->Port->AFR[hdht->PinIdx >> 3] |= (Alternate << 4*(hdht->PinIdx & 7));
+}
+
+//End of start pulse: arm the DMA edge capture and release the line
+static bool DHT22_IC_Arm(DHT22_HandleTypeDef *hdht)
+{
+	hdht->IcComplete = false;
+	//Bring pin HIGH so the hand-over to the timer produces no falling edge
+	ONE_WIRE_Pin_Write(hdht, 1);
+	//Arm capture before releasing, sensor answers 20-40uSec after release
+	if(HAL_TIM_IC_Start_DMA(hdht->htim, hdht->Channel, (uint32_t *)hdht->Edges, DHT22_IC_EDGES) != HAL_OK)
+	{
+		ONE_WIRE_PinMode(hdht, ONE_INPUT);
+		return 0;
+	}
+	//Hand the pin over to the timer channel
+	ONE_WIRE_PinMode(hdht, ONE_CAPTURE);
+	return 1;
+}
+
+//Send start pulse and arm the DMA edge capture
+bool DHT22_IC_Start(DHT22_HandleTypeDef *hdht)
+{
+	if(timActive != NULL || busActive != NULL) return 0;
+	timActive = hdht;
+	hdht->LastStartTick = HAL_GetTick();
+	//Change data pin mode to OUTPUT and hold the line LOW
+	ONE_WIRE_PinMode(hdht, ONE_OUTPUT);
+	ONE_WIRE_Pin_Write(hdht, 0);
+	//500uSec delay
+	DelayMicroSeconds(DHT22_START_LOW_US);
+	if(!DHT22_IC_Arm(hdht))
+	{
+		timActive = NULL;
+		return 0;
+	}
+	return 1;
+}
+
+//True once all frame edges have been captured
+bool DHT22_IC_IsComplete(DHT22_HandleTypeDef *hdht)
+{
+	return hdht->IcComplete;
+}
+
+//Abort an armed capture
+void DHT22_IC_Abort(DHT22_HandleTypeDef *hdht)
+{
+	HAL_TIM_IC_Stop_DMA(hdht->htim, hdht->Channel);
+	if(timActive == hdht) timActive = NULL;
+}
+
+//Abort a capture that ran out of time and classify the failure
+static DHT22_Status_Typedef DHT22_IC_Timeout(DHT22_HandleTypeDef *hdht)
+{
+	//Edges still missing when the frame timed out (TIM_DMA_ID_CCx is 1 + TIM_CHANNEL_x/4)
+	uint16_t captured = DHT22_IC_EDGES - __HAL_DMA_GET_COUNTER(hdht->htim->hdma[TIM_DMA_ID_CC1 + hdht->Channel/4]);
+	
+	DHT22_IC_Abort(hdht);
+	return DHT22_EdgesMissing(hdht, captured);
+}
+
+//Decode captured edges into Temperature and Humidity
+DHT22_Status_Typedef DHT22_IC_Decode(DHT22_HandleTypeDef *hdht, float *Temp, float *Humidity)
+{
+	DHT22_Status_Typedef status;
+	
+	if(!hdht->IcComplete) return DHT22_BUSY;
+	status = DHT22_DecodeEdges(hdht);
+	if(status == DHT22_OK)
+	{
+		*Temp = hdht->TempX10/10.0f;
+		*Humidity = hdht->HumidityX10/10.0f;
+	}
+	return status;
+}
+
+//Call from HAL_TIM_IC_CaptureCallback()
+void DHT22_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+	DHT22_HandleTypeDef *hdht = timActive;
+	
+	if(hdht == NULL || htim != hdht->htim) return;
+	//DMA transfer complete: all frame edges are in hdht->Edges[]
+	HAL_TIM_IC_Stop_DMA(hdht->htim, hdht->Channel);
+	hdht->IcComplete = true;
+	
+	if(hdht->State == DHT22_CAPTURING)
+	{
+		DHT22_Async_Finish(hdht, DHT22_DecodeEdges(hdht));
+	}
+	else
+	{
+		timActive = NULL;
+	}
+}
+
+//Start, sleep until captured (or timeout) then decode (0.1C, 0.1%RH)
+DHT22_Status_Typedef DHT22_IC_ReadX10(DHT22_HandleTypeDef *hdht, int16_t *TempX10, uint16_t *HumidityX10)
+{
+	uint32_t tickStart;
+	DHT22_Status_Typedef status;
+	
+	//Timer held by another reading: nothing was sent to the sensor, so nothing is counted
+	if(timActive != NULL || busActive != NULL) return DHT22_BUSY;
+	if(!DHT22_IC_Start(hdht)) return DHT22_Record(hdht, DHT22_ERR_NO_RESPONSE);
+	tickStart = HAL_GetTick();
+	while(!hdht->IcComplete)
+	{
+		if((HAL_GetTick() - tickStart) > DHT22_IC_TIMEOUT_MS)
+		{
+			return DHT22_Record(hdht, DHT22_IC_Timeout(hdht));
+		}
+		//Woken by SysTick or the DMA interrupt
+		__WFI();
+	}
+	status = DHT22_DecodeEdges(hdht);
+	if(status == DHT22_OK)
+	{
+		*TempX10 = hdht->TempX10;
+		*HumidityX10 = hdht->HumidityX10;
+	}
+	return DHT22_Record(hdht, status);
+}
+
+//Start, sleep until captured (or timeout) then decode
+DHT22_Status_Typedef DHT22_IC_Read(DHT22_HandleTypeDef *hdht, float *Temp, float *Humidity)
+{
+	int16_t TempX10;
+	uint16_t HumidityX10;
+	DHT22_Status_Typedef status = DHT22_IC_ReadX10(hdht, &TempX10, &HumidityX10);
+	
+	if(status == DHT22_OK)
+	{
+		*Temp = TempX10/10.0f;
+		*Humidity = HumidityX10/10.0f;
+	}
+	return status;
+}
+
+//*** Asynchronous acquisition ***//
+//A compare channel of the capture timer sequences the reading from interrupts:
+//  IDLE -> START_LOW  : line pulled low, compare fires after DHT22_START_LOW_US
+//  START_LOW -> CAPTURING : line released, DMA capture armed, compare reloaded as frame timeout
+//  CAPTURING -> DONE/ERROR : DMA complete (decoded) or compare timeout
+
+//Program the compare channel to fire uSec timer ticks from now
+static void DHT22_Async_Schedule(DHT22_HandleTypeDef *hdht, uint32_t uSec)
+{
+	__HAL_TIM_SET_COMPARE(hdht->htim, hdht->CompareChannel, __HAL_TIM_GET_COUNTER(hdht->htim) + uSec);
+	__HAL_TIM_CLEAR_IT(hdht->htim, hdht->CompareIT);
+	__HAL_TIM_ENABLE_IT(hdht->htim, hdht->CompareIT);
+}
+
+//Finish the running acquisition, free the timer and notify the application
+static void DHT22_Async_Finish(DHT22_HandleTypeDef *hdht, DHT22_Status_Typedef status)
+{
+	__HAL_TIM_DISABLE_IT(hdht->htim, hdht->CompareIT);
+	timActive = NULL;
+	DHT22_Complete(hdht, status);
+}
+
+//Attach compare channel of the capture timer (output compare in timing mode)
+void DHT22_Async_Init(DHT22_HandleTypeDef *hdht, uint32_t CompareChannel)
+{
+	hdht->CompareChannel = CompareChannel;
+	//TIM_CHANNEL_x is 4*(x-1), TIM_IT_CCx is CC1IE << (x-1)
+	hdht->CompareIT = TIM_IT_CC1 << (CompareChannel/4);
+	hdht->State = DHT22_IDLE;
+}
+
+//Begin a reading, returns 0 if one is already in flight on the timer
+bool DHT22_Async_Start(DHT22_HandleTypeDef *hdht, DHT22_Callback_Typedef callback)
+{
+	//Without DHT22_IC_Init()/DHT22_Async_Init() no compare would end START_LOW and the timer would stay held
+	if(hdht->htim == NULL || hdht->CompareIT == 0) return 0;
+	if(timActive != NULL || busActive != NULL) return 0;
+	
+	timActive = hdht;
+	hdht->Callback = callback;
+	hdht->State = DHT22_START_LOW;
+	hdht->LastStartTick = HAL_GetTick();
+	//Counter may have been stopped by the previous capture
+	__HAL_TIM_ENABLE(hdht->htim);
+	//Change data pin mode to OUTPUT and hold the line LOW
+	ONE_WIRE_PinMode(hdht, ONE_OUTPUT);
+	ONE_WIRE_Pin_Write(hdht, 0);
+	DHT22_Async_Schedule(hdht, DHT22_START_LOW_US);
+	return 1;
+}
+
+//Current acquisition state
+DHT22_State_Typedef DHT22_Async_Poll(DHT22_HandleTypeDef *hdht)
+{
+	return hdht->State;
+}
+
+//Fetch the result (0.1C, 0.1%RH) of a finished reading and return to IDLE
+DHT22_Status_Typedef DHT22_Async_GetResultX10(DHT22_HandleTypeDef *hdht, int16_t *TempX10, uint16_t *HumidityX10)
+{
+	if(hdht->State != DHT22_DONE && hdht->State != DHT22_ERROR) return DHT22_BUSY;
+	if(hdht->Status == DHT22_OK)
+	{
+		*TempX10 = hdht->TempX10;
+		*HumidityX10 = hdht->HumidityX10;
+	}
+	hdht->State = DHT22_IDLE;
+	return hdht->Status;
+}
+
+//Fetch the result of a finished reading and return to IDLE
+DHT22_Status_Typedef DHT22_Async_GetResult(DHT22_HandleTypeDef *hdht, float *Temp, float *Humidity)
+{
+	int16_t TempX10;
+	uint16_t HumidityX10;
+	DHT22_Status_Typedef status = DHT22_Async_GetResultX10(hdht, &TempX10, &HumidityX10);
+	
+	if(status == DHT22_OK)
+	{
+		*Temp = TempX10/10.0f;
+		*Humidity = HumidityX10/10.0f;
+	}
+	return status;
+}
+
+//Call from HAL_TIM_OC_DelayElapsedCallback()
+void DHT22_Async_CompareCallback(TIM_HandleTypeDef *htim)
+{
+	DHT22_HandleTypeDef *hdht = timActive;
+	
+	if(hdht == NULL || htim != hdht->htim || htim->Channel != (HAL_TIM_ActiveChannel)(hdht->CompareIT >> 1)) return;
+	
+	if(hdht->State == DHT22_START_LOW)
+	{
+		if(!DHT22_IC_Arm(hdht))
+		{
+			DHT22_Async_Finish(hdht, DHT22_ERR_NO_RESPONSE);
+			return;
+		}
+		hdht->State = DHT22_CAPTURING;
+		DHT22_Async_Schedule(hdht, DHT22_IC_TIMEOUT_MS*1000);
+	}
+	else if(hdht->State == DHT22_CAPTURING)
+	{
+		//Frame timeout: sensor missing or edges lost
+		DHT22_Async_Finish(hdht, DHT22_IC_Timeout(hdht));
+	}
+}
+
+//*** Multi-sensor bus ***//
+//Timer capture channels are few, so the bus samples whole GPIO ports instead:
+//the timer update event (every DHT22_BUS_SAMPLE_US) makes the DMA stream copy
+//Port->IDR into Samples[]. All pending sensors of one port are pulled low by one
+//port write, released together, and their frames arrive in the same ~5mSec window,
+//so N sensors on a port cost one frame. Ports are scanned back-to-back.
+//  IDLE -> START_LOW : pins of the next port pulled low
+//  START_LOW -> CAPTURING : DHT22_START_LOW_US elapsed, sampler armed, pins released
+//  CAPTURING -> START_LOW/DONE : window full, each sensor decoded from its IDR bit,
+//    or DMA transfer error / window overrun, the port's sensors fail with TIMEOUT
+
+//Attach sampling timer (1MHz) and the DMA stream on its update request
+void DHT22_Bus_Init(DHT22_Bus_Typedef *bus, TIM_HandleTypeDef *htim, DMA_HandleTypeDef *hdma)
+{
+	bus->Count = 0;
+	bus->htim = htim;
+	bus->hdma = hdma;
+	bus->State = DHT22_IDLE;
+	bus->Pending = 0;
+}
+
+//Add an initialised sensor
+bool DHT22_Bus_Add(DHT22_Bus_Typedef *bus, DHT22_HandleTypeDef *hdht)
+{
+	if(bus->Count >= DHT22_BUS_MAX_SENSORS) return 0;
+	bus->Sensors[bus->Count++] = hdht;
+	return 1;
+}
+
+//Pull all pending sensors of the next port low
+static void DHT22_Bus_StartPort(DHT22_Bus_Typedef *bus)
+{
+	DHT22_HandleTypeDef *hdht;
+	
+	bus->Port = NULL;
+	bus->PortPins = 0;
+	bus->PortModerMask = 0;
+	bus->PortModerOutput = 0;
+	for(uint8_t i=0; i<bus->Count; i++)
+	{
+		hdht = bus->Sensors[i];
+		if(!(bus->Pending & (1UL << i))) continue;
+		if(bus->Port == NULL) bus->Port = hdht->Port;
+		if(hdht->Port != bus->Port) continue;
+		bus->PortPins |= hdht->Pin;
+		bus->PortModerMask |= hdht->ModerMask;
+		bus->PortModerOutput |= hdht->ModerOutput;
+		hdht->State = DHT22_START_LOW;
+		hdht->LastStartTick = HAL_GetTick();
+	}
+	//One BSRR and one MODER write drive every line of the port low
+	hal_gpio_clear_pins(bus->Port, bus->PortPins);
+	bus->Port->MODER = (bus->Port->MODER & ~bus->PortModerMask) | bus->PortModerOutput;
+	
+	hal_dwt_deadline_set(&bus->Deadline, DHT22_START_LOW_US);
+	bus->State = DHT22_START_LOW;
+}
+
+//Decode every sensor of the sampled port
+static void DHT22_Bus_DecodePort(DHT22_Bus_Typedef *bus)
+{
+	DHT22_HandleTypeDef *hdht;
+	uint16_t captured;
+	bool level, prevLevel;
+	
+	for(uint8_t i=0; i<bus->Count; i++)
+	{
+		hdht = bus->Sensors[i];
+		if(!(bus->Pending & (1UL << i)) || hdht->Port != bus->Port) continue;
+		bus->Pending &= ~(1UL << i);
+		
+		//Falling edges of this line, timestamped in uSec from release
+		captured = 0;
+		//Line may still be rising from the release, an edge needs a HIGH sample first
+		prevLevel = 0;
+		for(uint16_t k=0; k<DHT22_BUS_SAMPLES && captured<DHT22_IC_EDGES; k++)
+		{
+			level = (bus->Samples[k] & hdht->Pin) != 0;
+			if(prevLevel && !level)
+			{
+				hdht->Edges[captured++] = k*DHT22_BUS_SAMPLE_US;
+			}
+			prevLevel = level;
+		}
+		
+		if(captured < DHT22_IC_EDGES) DHT22_Complete(hdht, DHT22_EdgesMissing(hdht, captured));
+		else DHT22_Complete(hdht, DHT22_DecodeEdges(hdht));
+	}
+}
+
+//Fail every pending sensor of the sampled port
+static void DHT22_Bus_FailPort(DHT22_Bus_Typedef *bus, DHT22_Status_Typedef status)
+{
+	for(uint8_t i=0; i<bus->Count; i++)
+	{
+		if(!(bus->Pending & (1UL << i)) || bus->Sensors[i]->Port != bus->Port) continue;
+		bus->Pending &= ~(1UL << i);
+		//No frame was sampled, no bit to blame
+		bus->Sensors[i]->FailedBit = -1;
+		DHT22_Complete(bus->Sensors[i], status);
+	}
+}
+
+//Begin reading every sensor
+bool DHT22_Bus_Start(DHT22_Bus_Typedef *bus, DHT22_Callback_Typedef callback)
+{
+	if(bus->Count == 0 || timActive != NULL || busActive != NULL) return 0;
+	
+	busActive = bus;
+	for(uint8_t i=0; i<bus->Count; i++)
+	{
+		bus->Sensors[i]->Callback = callback;
+		bus->Sensors[i]->State = DHT22_IDLE;
+	}
+	bus->Pending = (1UL << bus->Count) - 1;
+	//Sampling period replaces the capture period for the whole scan
+	bus->SavedPeriod = __HAL_TIM_GET_AUTORELOAD(bus->htim);
+	__HAL_TIM_SET_AUTORELOAD(bus->htim, DHT22_BUS_SAMPLE_US - 1);
+	__HAL_TIM_SET_COUNTER(bus->htim, 0);
+	__HAL_TIM_ENABLE(bus->htim);
+	DHT22_Bus_StartPort(bus);
+	return 1;
+}
+
+//Advance the scan
+DHT22_State_Typedef DHT22_Bus_Process(DHT22_Bus_Typedef *bus)
+{
+	bool failed;
+	
+	if(bus->State == DHT22_START_LOW)
+	{
+		if(!hal_dwt_deadline_expired(&bus->Deadline)) return bus->State;
+		//Arm the sampler before releasing, sensors answer 20-40uSec after release
+		hal_gpio_set_pins(bus->Port, bus->PortPins);
+		HAL_DMA_Start(bus->hdma, (uint32_t)&bus->Port->IDR, (uint32_t)bus->Samples, DHT22_BUS_SAMPLES);
+		__HAL_TIM_ENABLE_DMA(bus->htim, TIM_DMA_UPDATE);
+		//Release every line of the port to the pull-ups
+		bus->Port->MODER &= ~bus->PortModerMask;
+		for(uint8_t i=0; i<bus->Count; i++)
+		{
+			if(bus->Sensors[i]->Port == bus->Port && (bus->Pending & (1UL << i))) bus->Sensors[i]->State = DHT22_CAPTURING;
+		}
+		hal_dwt_deadline_set(&bus->Deadline, DHT22_BUS_SAMPLES*DHT22_BUS_SAMPLE_US + DHT22_BUS_MARGIN_US);
+		bus->State = DHT22_CAPTURING;
+	}
+	else if(bus->State == DHT22_CAPTURING)
+	{
+		//Window is full when the stream has no transfers left; a transfer error
+		//or a stopped timer never gets there, the port is failed instead
+		failed = __HAL_DMA_GET_FLAG(bus->hdma, __HAL_DMA_GET_TE_FLAG_INDEX(bus->hdma)) != 0;
+		if(!failed && __HAL_DMA_GET_COUNTER(bus->hdma) != 0)
+		{
+			if(!hal_dwt_deadline_expired(&bus->Deadline)) return bus->State;
+			failed = 1;
+		}
+		__HAL_TIM_DISABLE_DMA(bus->htim, TIM_DMA_UPDATE);
+		HAL_DMA_Abort(bus->hdma);
+		if(failed) DHT22_Bus_FailPort(bus, DHT22_ERR_TIMEOUT);
+		else DHT22_Bus_DecodePort(bus);
 		
-		*Temp = Temp16/10.0f;
-		*Humidity = Humid16/10.0f;
-		return 1;
+		if(bus->Pending != 0)
+		{
+			DHT22_Bus_StartPort(bus);
+		}
+		else
+		{
+			__HAL_TIM_SET_AUTORELOAD(bus->htim, bus->SavedPeriod);
+			busActive = NULL;
+			bus->State = DHT22_DONE;
+		}
 	}
-	return 0;
+	return bus->State;
 }
 
+//Start and process until every sensor has finished
+void DHT22_Bus_Read(DHT22_Bus_Typedef *bus)
+{
+	if(!DHT22_Bus_Start(bus, NULL)) return;
+	while(DHT22_Bus_Process(bus) != DHT22_DONE);
+}
@@ -22,6 +22,9 @@ References:				This library was written based on the DHT22 datasheet
 
 //Header files
 #include "stm32f4xx_hal.h"
+#include "hal_dwt_delay.h"
+#include "hal_gpio_fast.h"
+#include "arm_math.h"
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
@@ -31,26 +34,237 @@ typedef enum
 {
 	ONE_OUTPUT = 0,
 	ONE_INPUT,
+	ONE_CAPTURE,
 }OnePinMode_Typedef;
 
+//Read status
+typedef enum
+{
+	DHT22_OK = 0,
+	DHT22_ERR_NO_RESPONSE,		//Sensor did not answer the start signal
+	DHT22_ERR_TIMEOUT,				//Edge missing mid-frame, see DHT22_GetFailedBit()
+	DHT22_ERR_CHECKSUM,
+	DHT22_ERR_RANGE,					//Checksum ok but values outside the sensor limits
+	DHT22_ERR_RATE,						//Change from the last good reading faster than the rate limit
+	DHT22_BUSY,								//Reading still in flight, or the timer is held by another one
+	DHT22_STATUS_COUNT,
+}DHT22_Status_Typedef;
+
+//Per-status read counters
+typedef struct
+{
+	uint32_t Count[DHT22_STATUS_COUNT];
+}DHT22_Stats_Typedef;
+
+//Start signal
+#define DHT22_START_LOW_US			500		//Host holds the line low this long to wake the sensor
+
+//Bit-banged read timing
+#define DHT22_EDGE_TIMEOUT_US		100		//Longest expected level is the 80uSec response
+#define DHT22_BIT_THRESHOLD_US	48		//HIGH time; bit 0 is ~26uSec, bit 1 is ~70uSec
+
+//Sensor limits (x10)
+#define DHT22_HUMIDITY_MAX_X10	1000
+#define DHT22_TEMP_MIN_X10			-400
+#define DHT22_TEMP_MAX_X10			800
+
+//Default rate limits (x10 per second), catch bit errors the checksum let through
+#define DHT22_TEMP_RATE_X10			20
+#define DHT22_HUMIDITY_RATE_X10	100
+
+//Largest plausible change per second, 0 disables the check
+typedef struct
+{
+	uint16_t TempX10;
+	uint16_t HumidityX10;
+}DHT22_Rate_Typedef;
+
+//Batch decode settings
+typedef struct
+{
+	uint32_t PeriodMs;						//Time between frames, for the rate check
+	DHT22_Rate_Typedef Rate;
+	q15_t ScaleFract;							//Output = value x10 * ScaleFract/32768 * 2^Shift,
+	int8_t Shift;									//0x4000 with Shift 1 keeps 0.1 units
+}DHT22_Batch_Typedef;
+
+//Asynchronous acquisition state
+typedef enum
+{
+	DHT22_IDLE = 0,
+	DHT22_START_LOW,
+	DHT22_CAPTURING,
+	DHT22_DONE,
+	DHT22_ERROR,
+}DHT22_State_Typedef;
+
+//Sample cache
+#define DHT22_MIN_INTERVAL_MS		2000	//Sensor must not be started more often than this
+#define DHT22_SAMPLE_VALID			0x01	//Holds at least one good reading
+#define DHT22_SAMPLE_STALE			0x02	//Older than the stale limit (or never read)
+#define DHT22_SAMPLE_FAILED			0x04	//Last acquisition failed, see LastStatus
+#define DHT22_SAMPLE_REFRESHING	0x08	//Acquisition in flight
+
+//Last good reading with its age and quality
+typedef struct
+{
+	int16_t TempX10;							//0.1C
+	uint16_t HumidityX10;					//0.1%RH
+	uint32_t Tick;								//HAL_GetTick() when it was read
+	uint32_t AgeMs;								//Filled by DHT22_Cache_Get()
+	uint8_t Flags;								//DHT22_SAMPLE_x
+	DHT22_Status_Typedef LastStatus;
+}DHT22_Sample_Typedef;
+
+//Input capture backend
+#define DHT22_IC_EDGES					42		//Falling edges per frame: response + start of bit 0 + end of each of the 40 bits
+#define DHT22_IC_BIT_THRESHOLD	100		//uSec between falling edges; bit 0 is ~76uSec, bit 1 is ~120uSec
+#define DHT22_IC_MAX_PERIOD			200		//uSec; longer means an edge was lost
+#define DHT22_IC_TIMEOUT_MS			10		//Whole frame is ~5mSec
+
+//Sensor handle, one per data line
+typedef struct __DHT22_HandleTypeDef
+{
+	//1. One wire data line
+	GPIO_TypeDef *Port;
+	uint16_t Pin;
+	uint8_t PinIdx;
+	uint32_t ModerMask;						//Precomputed in DHT22_Init(), pin fast path
+	uint32_t ModerOutput;
+	uint32_t ModerAF;
+	bool OpenDrain;								//Line stays an output, released by writing 1
+	//2. Input capture timer (optional)
+	TIM_HandleTypeDef *htim;
+	uint32_t Channel;
+	uint32_t Alternate;
+	uint16_t Edges[DHT22_IC_EDGES];		//Falling edge timestamps, uSec
+	volatile bool IcComplete;
+	//3. Asynchronous acquisition
+	uint32_t CompareChannel;
+	uint32_t CompareIT;
+	volatile DHT22_State_Typedef State;
+	void (*Callback)(struct __DHT22_HandleTypeDef *hdht, DHT22_Status_Typedef status, float Temp, float Humidity);
+	DHT22_Status_Typedef Status;
+	int16_t TempX10;							//Last decoded reading, 0.1C
+	uint16_t HumidityX10;					//0.1%RH
+	//4. Diagnostics
+	DHT22_Rate_Typedef Rate;
+	int8_t FailedBit;
+	DHT22_Stats_Typedef Stats;
+	//5. Sample cache
+	DHT22_Sample_Typedef Cache;
+	uint32_t StaleMs;
+	uint32_t LastStartTick;				//Last start pulse, for the minimum interval
+}DHT22_HandleTypeDef;
+
+//Completion callback, called from interrupt context (or from DHT22_Bus_Process())
+typedef void (*DHT22_Callback_Typedef)(DHT22_HandleTypeDef *hdht, DHT22_Status_Typedef status, float Temp, float Humidity);
+
+//Multi-sensor bus
+#define DHT22_BUS_MAX_SENSORS		16
+#define DHT22_BUS_SAMPLE_US			5			//Port sampling period
+#define DHT22_BUS_SAMPLES				1120	//5.6mSec window: response + 40 bits of up to ~120uSec
+#define DHT22_BUS_MARGIN_US			1000	//Window overrun before a stalled timer or stream is given up
+
+//Sensors sharing one sampling timer + DMA stream. All sensors of a GPIO port are
+//started by a single port write and decoded from the same IDR samples; ports are
+//scanned back-to-back.
+typedef struct
+{
+	DHT22_HandleTypeDef *Sensors[DHT22_BUS_MAX_SENSORS];
+	uint8_t Count;
+	TIM_HandleTypeDef *htim;			//1MHz timebase, its update event triggers hdma
+	DMA_HandleTypeDef *hdma;			//Peripheral to memory, halfword, on the timer update request
+	uint16_t Samples[DHT22_BUS_SAMPLES];
+	//Scan progress
+	volatile DHT22_State_Typedef State;
+	uint32_t Pending;							//Sensors not yet read, bit per Sensors[] index
+	GPIO_TypeDef *Port;						//Port being read
+	uint16_t PortPins;
+	uint32_t PortModerMask;
+	uint32_t PortModerOutput;
+	uint32_t SavedPeriod;
+	hal_dwt_deadline_t Deadline;	//End of the start pulse, then of the sampling window
+}DHT22_Bus_Typedef;
+
 
 
 //*** Functions prototypes ***//
 //OneWire Initialise
-void DHT22_Init(GPIO_TypeDef* DataPort, uint16_t DataPin);
-//Change pin mode
-static void ONE_WIRE_PinMode(OnePinMode_Typedef mode);
-//One Wire pin HIGH/LOW Write
-static void ONE_WIRE_Pin_Write(bool state);
-static bool ONE_WIRE_Pin_Read(void);
-//Microsecond delay
-static void DelayMicroSeconds(uint32_t uSec);
-//Begin function
-static void DHT22_StartAcquisition(void);
-//Read 5 bytes
-static void DHT22_ReadRaw(uint8_t *data);
+void DHT22_Init(DHT22_HandleTypeDef *hdht, GPIO_TypeDef* DataPort, uint16_t DataPin);
+//Open-drain line (needs the external pull-up): no direction switching for the bit-banged read
+void DHT22_SetOpenDrain(DHT22_HandleTypeDef *hdht, bool enable);
+//Rate limits, defaults are DHT22_TEMP_RATE_X10 / DHT22_HUMIDITY_RATE_X10
+void DHT22_SetRateLimit(DHT22_HandleTypeDef *hdht, uint16_t TempX10, uint16_t HumidityX10);
 
+//Read Temperature (0.1C) and Humidity (0.1%RH) without floating point, every wait is bounded
+DHT22_Status_Typedef DHT22_ReadX10(DHT22_HandleTypeDef *hdht, int16_t *TempX10, uint16_t *HumidityX10);
+//Read Temperature and Humidity, every wait is bounded
+DHT22_Status_Typedef DHT22_Read(DHT22_HandleTypeDef *hdht, float *Temp, float *Humidity);
 //Get Temperature and Humidity data
-bool DHT22_GetTemp_Humidity(float *Temp, float *Humidity);
+bool DHT22_GetTemp_Humidity(DHT22_HandleTypeDef *hdht, float *Temp, float *Humidity);
+//Bit index (0-39) at which the last TIMEOUT occurred, -1 if none
+int8_t DHT22_GetFailedBit(DHT22_HandleTypeDef *hdht);
+//Failure mode counters
+const DHT22_Stats_Typedef *DHT22_GetStats(DHT22_HandleTypeDef *hdht);
+//Printable status name
+const char *DHT22_StatusString(DHT22_Status_Typedef status);
+
+//*** Batch decode ***//
+//Decode `count` raw frames of 5 bytes (oldest first, PeriodMs apart) into status[] and output values; every
+//output is clipped to the sensor limits and scaled, rejected frames included. Returns the number of good frames
+uint16_t DHT22_DecodeBatch(const DHT22_Batch_Typedef *batch, const uint8_t *frames, uint16_t count,
+													 q15_t *TempOut, q15_t *HumidityOut, DHT22_Status_Typedef *status);
+
+//*** Sample cache ***//
+//Keep readings for StaleMs (at least DHT22_MIN_INTERVAL_MS) before refreshing
+void DHT22_Cache_Init(DHT22_HandleTypeDef *hdht, uint32_t StaleMs);
+//Last good sample with age and flags, returns at once; starts a background refresh when stale
+bool DHT22_Cache_Get(DHT22_HandleTypeDef *hdht, DHT22_Sample_Typedef *sample);
+
+//*** Input capture + DMA backend ***//
+//Attach timer channel wired to the data pin (timer must tick at 1MHz, channel set to falling edge capture)
+void DHT22_IC_Init(DHT22_HandleTypeDef *hdht, TIM_HandleTypeDef *htim, uint32_t Channel, uint32_t Alternate);
+//Send start pulse and arm the DMA edge capture, returns immediately (0 if the timer is in use)
+bool DHT22_IC_Start(DHT22_HandleTypeDef *hdht);
+//True once all frame edges have been captured
+bool DHT22_IC_IsComplete(DHT22_HandleTypeDef *hdht);
+//Abort an armed capture
+void DHT22_IC_Abort(DHT22_HandleTypeDef *hdht);
+//Decode captured edges into Temperature and Humidity
+DHT22_Status_Typedef DHT22_IC_Decode(DHT22_HandleTypeDef *hdht, float *Temp, float *Humidity);
+//Call from HAL_TIM_IC_CaptureCallback()
+void DHT22_IC_CaptureCallback(TIM_HandleTypeDef *htim);
+//Start, sleep until captured (or timeout) then decode (0.1C, 0.1%RH); DHT22_BUSY if the timer is in use
+DHT22_Status_Typedef DHT22_IC_ReadX10(DHT22_HandleTypeDef *hdht, int16_t *TempX10, uint16_t *HumidityX10);
+//Start, sleep until captured (or timeout) then decode
+DHT22_Status_Typedef DHT22_IC_Read(DHT22_HandleTypeDef *hdht, float *Temp, float *Humidity);
+
+//*** Asynchronous acquisition (timer compare state machine) ***//
+//Attach compare channel of the capture timer (output compare in timing mode)
+void DHT22_Async_Init(DHT22_HandleTypeDef *hdht, uint32_t CompareChannel);
+//Begin a reading, returns immediately; callback may be NULL. Returns 0 if the timer is in use or the handle lacks DHT22_IC_Init()/DHT22_Async_Init()
+bool DHT22_Async_Start(DHT22_HandleTypeDef *hdht, DHT22_Callback_Typedef callback);
+//Current acquisition state
+DHT22_State_Typedef DHT22_Async_Poll(DHT22_HandleTypeDef *hdht);
+//Fetch the result (0.1C, 0.1%RH) of a finished reading and return to IDLE (DHT22_BUSY while in flight)
+DHT22_Status_Typedef DHT22_Async_GetResultX10(DHT22_HandleTypeDef *hdht, int16_t *TempX10, uint16_t *HumidityX10);
+//Fetch the result of a finished reading and return to IDLE (DHT22_BUSY while in flight)
+DHT22_Status_Typedef DHT22_Async_GetResult(DHT22_HandleTypeDef *hdht, float *Temp, float *Humidity);
+//Call from HAL_TIM_OC_DelayElapsedCallback()
+void DHT22_Async_CompareCallback(TIM_HandleTypeDef *htim);
+
+//*** Multi-sensor bus ***//
+//Attach sampling timer (1MHz) and the DMA stream on its update request
+void DHT22_Bus_Init(DHT22_Bus_Typedef *bus, TIM_HandleTypeDef *htim, DMA_HandleTypeDef *hdma);
+//Add an initialised sensor, returns 0 when the bus is full
+bool DHT22_Bus_Add(DHT22_Bus_Typedef *bus, DHT22_HandleTypeDef *hdht);
+//Begin reading every sensor, returns 0 if a scan or capture is already running
+bool DHT22_Bus_Start(DHT22_Bus_Typedef *bus, DHT22_Callback_Typedef callback);
+//Advance the scan, call from the main loop. A stalled sampler fails the port
+//with DHT22_ERR_TIMEOUT after the window plus DHT22_BUS_MARGIN_US
+DHT22_State_Typedef DHT22_Bus_Process(DHT22_Bus_Typedef *bus);
+//Start and process until every sensor has finished
+void DHT22_Bus_Read(DHT22_Bus_Typedef *bus);
 
 #endif
@@ -0,0 +1,193 @@
+/*
+Library:					UART RX - Circular DMA reception with IDLE line detection
+Description:			See MY_UART_RX.h. The receive events only move Head forward, the application only moves Tail,
+									so the buffer needs no lock and no interrupt masking.
+*/
+
+//Header files
+#include "MY_UART_RX.h"
+
+
+//Wrapped UARTs, looked up by the HAL callbacks
+static UART_RX_HandleTypedef *rxActive[UART_RX_MAX_HANDLES];
+
+//*** Functions prototypes ***//
+//Handle of a UART, NULL when not wrapped
+static UART_RX_HandleTypedef *UART_RX_Find(UART_HandleTypeDef *huart)
+{
+	for(uint8_t i=0; i<UART_RX_MAX_HANDLES; i++)
+	{
+		if(rxActive[i] != NULL && rxActive[i]->huart == huart) return rxActive[i];
+	}
+	return NULL;
+}
+
+//Start the DMA at the beginning of the buffer, half transfer interrupt left enabled
+static HAL_StatusTypeDef UART_RX_Begin(UART_RX_HandleTypedef *hrx)
+{
+	hrx->Pos = 0;
+	hrx->Restart = false;
+	return HAL_UARTEx_ReceiveToIdle_DMA(hrx->huart, hrx->Buffer, hrx->Size);
+}
+
+//Publish the bytes written by the DMA up to buffer index pos
+static void UART_RX_Publish(UART_RX_HandleTypedef *hrx, uint16_t pos)
+{
+	uint16_t len;
+
+	//Transfer complete reports the full size, the DMA is back at index 0
+	if(pos >= hrx->Size) pos = 0;
+	if(pos == hrx->Pos) return;
+
+	if(pos > hrx->Pos)
+	{
+		len = pos - hrx->Pos;
+		if(hrx->Callback != NULL) hrx->Callback(hrx->Buffer + hrx->Pos, len);
+	}
+	else
+	{
+		len = hrx->Size - hrx->Pos + pos;
+		if(hrx->Callback != NULL)
+		{
+			hrx->Callback(hrx->Buffer + hrx->Pos, hrx->Size - hrx->Pos);
+			if(pos) hrx->Callback(hrx->Buffer, pos);
+		}
+	}
+	hrx->Pos = pos;
+	hrx->Head += len;
+}
+
+//Start circular reception, the handle must stay valid until UART_RX_Stop()
+HAL_StatusTypeDef UART_RX_Start(UART_RX_HandleTypedef *hrx, UART_HandleTypeDef *huart, uint8_t *Buffer, uint16_t Size, UART_RX_Callback_Typedef Callback)
+{
+	uint8_t slot = UART_RX_MAX_HANDLES;
+
+	//Free running indices wrap with the buffer only for a power of two
+	if(huart->hdmarx == NULL || Size < 2 || (Size & (Size - 1)) != 0) return HAL_ERROR;
+
+	for(uint8_t i=0; i<UART_RX_MAX_HANDLES; i++)
+	{
+		if(rxActive[i] == hrx || (rxActive[i] != NULL && rxActive[i]->huart == huart)) return HAL_BUSY;
+		if(rxActive[i] == NULL && slot == UART_RX_MAX_HANDLES) slot = i;
+	}
+	if(slot == UART_RX_MAX_HANDLES) return HAL_BUSY;
+
+	memset(hrx, 0, sizeof(*hrx));
+	hrx->huart = huart;
+	hrx->Buffer = Buffer;
+	hrx->Size = Size;
+	hrx->Callback = Callback;
+	rxActive[slot] = hrx;
+
+	if(UART_RX_Begin(hrx) != HAL_OK)
+	{
+		rxActive[slot] = NULL;
+		return HAL_ERROR;
+	}
+	return HAL_OK;
+}
+
+//Stop reception, what arrived since the last event is still published
+void UART_RX_Stop(UART_RX_HandleTypedef *hrx)
+{
+	HAL_UART_AbortReceive(hrx->huart);
+	UART_RX_Publish(hrx, hrx->Size - __HAL_DMA_GET_COUNTER(hrx->huart->hdmarx));
+
+	for(uint8_t i=0; i<UART_RX_MAX_HANDLES; i++)
+	{
+		if(rxActive[i] == hrx) rxActive[i] = NULL;
+	}
+}
+
+//Copy up to Len received bytes, never waits
+uint16_t UART_RX_Read(UART_RX_HandleTypedef *hrx, uint8_t *Data, uint16_t Len)
+{
+	uint32_t head = hrx->Head;
+	uint32_t avail = head - hrx->Tail;
+	uint16_t n = 0, idx, chunk;
+
+	//The DMA has lapped the application, keep the newest Size bytes
+	if(avail > hrx->Size)
+	{
+		hrx->Skipped += avail - hrx->Size;
+		hrx->Tail = head - hrx->Size;
+		avail = hrx->Size;
+	}
+	if(Len > avail) Len = avail;
+
+	while(n < Len)
+	{
+		idx = hrx->Tail & (hrx->Size - 1);
+		chunk = hrx->Size - idx;
+		if(chunk > Len - n) chunk = Len - n;
+		memcpy(Data + n, hrx->Buffer + idx, chunk);
+		n += chunk;
+		hrx->Tail += chunk;
+	}
+
+	//After a line error the DMA starts again at index 0, once everything before it has been read
+	if(hrx->Restart && hrx->Tail == hrx->Head)
+	{
+		hrx->Head = 0;
+		hrx->Tail = 0;
+		UART_RX_Begin(hrx);
+	}
+	return n;
+}
+
+//Bytes waiting in the buffer
+uint16_t UART_RX_Available(UART_RX_HandleTypedef *hrx)
+{
+	uint32_t avail = hrx->Head - hrx->Tail;
+
+	return avail > hrx->Size ? hrx->Size : (uint16_t)avail;
+}
+
+//Bytes lost to a full buffer; a line error also loses the byte in error and what arrives until the restart
+uint32_t UART_RX_Dropped(UART_RX_HandleTypedef *hrx)
+{
+	return hrx->Skipped + hrx->Errors;
+}
+
+//Collect a line from whatever has arrived, empty lines (e.g. the \n of a \r\n) are skipped
+bool UART_RX_ReadLine(UART_RX_HandleTypedef *hrx, char *Line, uint16_t MaxLen)
+{
+	uint8_t ch;
+
+	while(UART_RX_Read(hrx, &ch, 1))
+	{
+		if(ch == '\n' || ch == '\r')
+		{
+			if(hrx->LineLen == 0) continue;
+			Line[hrx->LineLen] = '\0';
+			hrx->LineLen = 0;
+			return true;
+		}
+		//The rest of a long line is dropped
+		if(hrx->LineLen < MaxLen - 1) Line[hrx->LineLen++] = (char)ch;
+	}
+	return false;
+}
+
+//*** HAL callbacks ***//
+//Half transfer, transfer complete and IDLE all report the buffer index the DMA has reached
+void UART_RX_EventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+	UART_RX_HandleTypedef *hrx = UART_RX_Find(huart);
+
+	if(hrx != NULL) UART_RX_Publish(hrx, Size);
+}
+
+//The HAL aborts a DMA reception on any line error, publish what arrived before it and restart
+void UART_RX_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	UART_RX_HandleTypedef *hrx = UART_RX_Find(huart);
+
+	if(hrx == NULL || huart->RxState != HAL_UART_STATE_READY) return;
+
+	UART_RX_Publish(hrx, hrx->Size - __HAL_DMA_GET_COUNTER(huart->hdmarx));
+	hrx->Errors++;
+	//With a callback every byte has been delivered, otherwise unread bytes would be overwritten from index 0
+	if(hrx->Callback != NULL) UART_RX_Begin(hrx);
+	else hrx->Restart = true;
+}
@@ -0,0 +1,58 @@
+/*
+Library:					UART RX - Circular DMA reception with IDLE line detection
+Description:			Wrapper around a HAL UART handle (huart2 in this project). The DMA writes every received byte
+									into a circular buffer without stopping; the USART IDLE interrupt (end of a frame) and the DMA
+									half/full transfer interrupts publish the new region of the buffer, so there is no interrupt
+									per byte and nothing is lost as long as the buffer is emptied within Size / 2 character times.
+*/
+
+#ifndef MY_UART_RX_H
+#define MY_UART_RX_H
+
+
+//Header files
+#include "stm32f4xx_hal.h"
+#include <stdbool.h>
+#include <string.h>
+
+//UARTs that can be wrapped at the same time
+#define UART_RX_MAX_HANDLES			3
+
+//New region of the buffer, called from interrupt context; twice when the region wraps
+typedef void (*UART_RX_Callback_Typedef)(const uint8_t *Data, uint16_t Len);
+
+//Reception handle, one per UART
+typedef struct
+{
+	UART_HandleTypeDef *huart;		//hdmarx linked, circular, peripheral to memory, byte
+	uint8_t *Buffer;							//Written by the DMA
+	uint16_t Size;								//Power of two
+	uint16_t Pos;									//Buffer index published so far
+	volatile uint32_t Head;				//Bytes published, free running; written by the receive events only
+	uint32_t Tail;								//Bytes taken by the application, free running
+	uint32_t Skipped;							//Bytes overwritten by the DMA before they were read
+	volatile uint32_t Errors;			//Receptions stopped by a line error (framing, noise, overrun)
+	volatile bool Restart;				//Reception stopped, restarted by the next UART_RX_Read()
+	uint16_t LineLen;							//Partial line of UART_RX_ReadLine()
+	UART_RX_Callback_Typedef Callback;
+}UART_RX_HandleTypedef;
+
+//*** Functions prototypes ***//
+//Start circular reception into Buffer; Callback may be NULL, the data is then taken with UART_RX_Read()/UART_RX_ReadLine()
+HAL_StatusTypeDef UART_RX_Start(UART_RX_HandleTypedef *hrx, UART_HandleTypeDef *huart, uint8_t *Buffer, uint16_t Size, UART_RX_Callback_Typedef Callback);
+//Stop reception, unread bytes stay readable
+void UART_RX_Stop(UART_RX_HandleTypedef *hrx);
+//Copy up to Len received bytes, never waits
+uint16_t UART_RX_Read(UART_RX_HandleTypedef *hrx, uint8_t *Data, uint16_t Len);
+//Bytes waiting in the buffer
+uint16_t UART_RX_Available(UART_RX_HandleTypedef *hrx);
+//Bytes lost to a full buffer or a line error
+uint32_t UART_RX_Dropped(UART_RX_HandleTypedef *hrx);
+//Collect a line without waiting: true when Line holds a complete line ('\r'/'\n' removed), pass the same Line until then
+bool UART_RX_ReadLine(UART_RX_HandleTypedef *hrx, char *Line, uint16_t MaxLen);
+
+//*** HAL callbacks, call from HAL_UARTEx_RxEventCallback()/HAL_UART_ErrorCallback() ***//
+void UART_RX_EventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+void UART_RX_ErrorCallback(UART_HandleTypeDef *huart);
+
+#endif
@@ -0,0 +1,145 @@
+/*
+Library:					UART TX - Zero-copy DMA transmit queue
+Description:			See MY_UART_TX.h. The application only moves Head, the completion callback only moves Tail;
+									a transfer is started either from the completion callback or, when the DMA is idle, by
+									UART_TX_Send() with interrupts masked for the few instructions of the start.
+*/
+
+//Header files
+#include "MY_UART_TX.h"
+
+
+//Wrapped UARTs, looked up by the HAL callbacks
+static UART_TX_HandleTypedef *txActive[UART_TX_MAX_HANDLES];
+
+//*** Functions prototypes ***//
+//Handle of a UART, NULL when not wrapped
+static UART_TX_HandleTypedef *UART_TX_Find(UART_HandleTypeDef *huart)
+{
+	for(uint8_t i=0; i<UART_TX_MAX_HANDLES; i++)
+	{
+		if(txActive[i] != NULL && txActive[i]->huart == huart) return txActive[i];
+	}
+	return NULL;
+}
+
+//Hand the descriptor at the tail back to its owner
+static void UART_TX_Retire(UART_TX_HandleTypedef *htx)
+{
+	UART_TX_Desc_Typedef *desc = &htx->Queue[htx->Tail & (UART_TX_QUEUE_LEN - 1)];
+
+	htx->Tail++;
+	if(desc->Done != NULL) desc->Done(desc->Data, desc->Len);
+}
+
+//Start the descriptor at the tail, interrupt context or interrupts masked
+static void UART_TX_Next(UART_TX_HandleTypedef *htx)
+{
+	UART_TX_Desc_Typedef *desc;
+
+	while(htx->Tail != htx->Head)
+	{
+		desc = &htx->Queue[htx->Tail & (UART_TX_QUEUE_LEN - 1)];
+		if(desc->Len == 0)
+		{
+			UART_TX_Retire(htx);
+			continue;
+		}
+		if(HAL_UART_Transmit_DMA(htx->huart, (uint8_t *)desc->Data, desc->Len) == HAL_OK)
+		{
+			htx->Busy = true;
+			return;
+		}
+		//UART busy with a blocking transfer or in error, the buffer is given back unsent
+		htx->Errors++;
+		UART_TX_Retire(htx);
+	}
+	htx->Busy = false;
+}
+
+//Attach the queue to a UART
+HAL_StatusTypeDef UART_TX_Init(UART_TX_HandleTypedef *htx, UART_HandleTypeDef *huart)
+{
+	uint8_t slot = UART_TX_MAX_HANDLES;
+
+	if(huart->hdmatx == NULL) return HAL_ERROR;
+
+	for(uint8_t i=0; i<UART_TX_MAX_HANDLES; i++)
+	{
+		if(txActive[i] == htx || (txActive[i] != NULL && txActive[i]->huart == huart)) return HAL_BUSY;
+		if(txActive[i] == NULL && slot == UART_TX_MAX_HANDLES) slot = i;
+	}
+	if(slot == UART_TX_MAX_HANDLES) return HAL_BUSY;
+
+	memset(htx, 0, sizeof(*htx));
+	htx->huart = huart;
+	txActive[slot] = htx;
+	return HAL_OK;
+}
+
+//Queue a buffer, it belongs to the driver until Done is called
+bool UART_TX_Send(UART_TX_HandleTypedef *htx, const uint8_t *Data, uint16_t Len, UART_TX_Done_Typedef Done)
+{
+	uint32_t head = htx->Head;
+	UART_TX_Desc_Typedef *desc;
+	uint32_t primask;
+
+	if(head - htx->Tail >= UART_TX_QUEUE_LEN) return false;
+
+	desc = &htx->Queue[head & (UART_TX_QUEUE_LEN - 1)];
+	desc->Data = Data;
+	desc->Len = Len;
+	desc->Done = Done;
+	htx->Head = head + 1;
+
+	//Idle DMA: start here; the completion callback cannot run in between
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if(!htx->Busy) UART_TX_Next(htx);
+	__set_PRIMASK(primask);
+	return true;
+}
+
+//Queue a constant string
+bool UART_TX_SendString(UART_TX_HandleTypedef *htx, const char *Str)
+{
+	return UART_TX_Send(htx, (const uint8_t *)Str, strlen(Str), NULL);
+}
+
+//Descriptors left in the queue
+uint16_t UART_TX_QueueFree(UART_TX_HandleTypedef *htx)
+{
+	return UART_TX_QUEUE_LEN - (htx->Head - htx->Tail);
+}
+
+//Buffer at Data is still queued or being sent, so it must not be written yet
+bool UART_TX_Pending(UART_TX_HandleTypedef *htx, const void *Data)
+{
+	for(uint32_t i = htx->Tail; i != htx->Head; i++)
+	{
+		if(htx->Queue[i & (UART_TX_QUEUE_LEN - 1)].Data == Data) return true;
+	}
+	return false;
+}
+
+//*** HAL callbacks ***//
+//Last byte sent, hand the buffer back and start the next one
+void UART_TX_CpltCallback(UART_HandleTypeDef *huart)
+{
+	UART_TX_HandleTypedef *htx = UART_TX_Find(huart);
+
+	if(htx == NULL || !htx->Busy) return;
+	UART_TX_Retire(htx);
+	UART_TX_Next(htx);
+}
+
+//A DMA error aborts the transfer, skip to the next descriptor
+void UART_TX_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	UART_TX_HandleTypedef *htx = UART_TX_Find(huart);
+
+	if(htx == NULL || !htx->Busy || huart->gState != HAL_UART_STATE_READY) return;
+	htx->Errors++;
+	UART_TX_Retire(htx);
+	UART_TX_Next(htx);
+}
@@ -0,0 +1,62 @@
+/*
+Library:					UART TX - Zero-copy DMA transmit queue
+Description:			Wrapper around a HAL UART handle (huart2 in this project). The application queues descriptors
+									(pointer, length, completion callback) and the DMA sends them one after the other, the next one
+									started from the completion interrupt. Nothing is copied: constant strings are sent in place and
+									formatted buffers are lent to the driver until their callback (or UART_TX_Pending()) says they
+									have been sent.
+*/
+
+#ifndef MY_UART_TX_H
+#define MY_UART_TX_H
+
+
+//Header files
+#include "stm32f4xx_hal.h"
+#include <stdbool.h>
+#include <string.h>
+
+//UARTs that can be wrapped at the same time
+#define UART_TX_MAX_HANDLES			3
+//Descriptors per UART, power of two
+#define UART_TX_QUEUE_LEN				8
+
+//Buffer sent and handed back, called from interrupt context
+typedef void (*UART_TX_Done_Typedef)(const uint8_t *Data, uint16_t Len);
+
+//One buffer to send
+typedef struct
+{
+	const uint8_t *Data;
+	uint16_t Len;
+	UART_TX_Done_Typedef Done;		//NULL for constant data
+}UART_TX_Desc_Typedef;
+
+//Transmit handle, one per UART
+typedef struct
+{
+	UART_HandleTypeDef *huart;		//hdmatx linked, normal mode, memory to peripheral, byte
+	UART_TX_Desc_Typedef Queue[UART_TX_QUEUE_LEN];
+	volatile uint32_t Head;				//Descriptors queued, free running; written by the application only
+	volatile uint32_t Tail;				//Descriptors sent, free running; written by the completion callback only
+	volatile bool Busy;						//DMA is sending Queue[Tail]
+	volatile uint32_t Errors;			//Descriptors the HAL refused or aborted
+}UART_TX_HandleTypedef;
+
+//*** Functions prototypes ***//
+//Attach the queue to a UART
+HAL_StatusTypeDef UART_TX_Init(UART_TX_HandleTypedef *htx, UART_HandleTypeDef *huart);
+//Queue Len bytes at Data, untouched until Done is called; false when the queue is full
+bool UART_TX_Send(UART_TX_HandleTypedef *htx, const uint8_t *Data, uint16_t Len, UART_TX_Done_Typedef Done);
+//Queue a string that never changes (a literal)
+bool UART_TX_SendString(UART_TX_HandleTypedef *htx, const char *Str);
+//Descriptors left in the queue
+uint16_t UART_TX_QueueFree(UART_TX_HandleTypedef *htx);
+//Buffer at Data is still queued or being sent
+bool UART_TX_Pending(UART_TX_HandleTypedef *htx, const void *Data);
+
+//*** HAL callbacks, call from HAL_UART_TxCpltCallback()/HAL_UART_ErrorCallback() ***//
+void UART_TX_CpltCallback(UART_HandleTypeDef *huart);
+void UART_TX_ErrorCallback(UART_HandleTypeDef *huart);
+
+#endif
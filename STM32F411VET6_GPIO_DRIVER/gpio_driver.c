@@ -1 +0,0 @@
-#include "gpio_driver.h"
\ No newline at end of file
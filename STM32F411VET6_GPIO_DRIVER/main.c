@@ -1,7 +1,23 @@
-
+#include "led.h"
+#include "hal_dwt_delay.h"
 
 int main(void)
+		
 {
+	led_init();
+	hal_dwt_init();
+		
+	while(1)
+	{
+			
+	 /* Both LEDs change with one BSRR store */
+	 led_toggle_mask(GPIOD,(1U << LED_ORANGE) | (1U << LED_BLUE));
+			
+	 hal_dwt_delay_ms(125);
+			
+	}
+		
+		
+}
+	
 	
-	return 0;
-}
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*
+ * Register memory, counter and UART of the host mock-register build, see host_mock.h.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "host_mock.h"
+#include "hal_uart_driver.h"
+
+/* Normally defined by system_stm32f4xx.c: HSI after reset */
+uint32_t SystemCoreClock = 16000000U;
+
+static int perf_fd = -1;
+
+/* Address ranges the firmware touches */
+static const struct
+{
+	uintptr_t base;
+	size_t size;
+}mock_regions[] =
+{
+	{ 0x40000000U, 0x00100000U },           /* APB1, APB2, AHB1 peripherals */
+	{ 0x42000000U, 0x02000000U },           /* Peripheral bit-band alias */
+	{ 0xE0000000U, 0x00100000U },           /* DWT, NVIC, SCB, CoreDebug */
+};
+
+static void mock_map(void)
+{
+	for (size_t i = 0; i < sizeof(mock_regions) / sizeof(mock_regions[0]); i++)
+	{
+		void *p = mmap((void *)mock_regions[i].base, mock_regions[i].size, PROT_READ | PROT_WRITE,
+		               MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE, -1, 0);
+
+		if (p != (void *)mock_regions[i].base)
+		{
+			fprintf(stderr, "host_mock: cannot map registers at 0x%08lX\n", (unsigned long)mock_regions[i].base);
+			exit(2);
+		}
+	}
+}
+
+static void mock_perf_open(void)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/* Before main() and before any static initializer could touch a register */
+__attribute__((constructor)) static void mock_init(void)
+{
+	mock_map();
+	mock_perf_open();
+}
+
+uint32_t host_bench_counter(void)
+{
+	uint64_t count;
+	struct timespec ts;
+
+	if (perf_fd >= 0 && read(perf_fd, &count, sizeof(count)) == sizeof(count))
+	{
+		return (uint32_t)count;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec);
+}
+
+const char *host_bench_unit(void)
+{
+	return perf_fd >= 0 ? "instructions" : "ns";
+}
+
+/* USART2 replaced by stdout */
+void uart_init(void)
+{
+}
+
+void uart_send_string(const char *str)
+{
+	fputs(str, stdout);
+}
+
+void uart_send_bytes(const uint8_t *data, uint32_t len)
+{
+	fwrite(data, 1, len, stdout);
+}
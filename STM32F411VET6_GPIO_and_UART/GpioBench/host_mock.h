@@ -0,0 +1,25 @@
+/*
+ * Host mock-register build of the GPIO benchmark, included by bench_main.c when GPIO_BENCH_HOST is defined.
+ *
+ * host_mock.c maps plain memory at the peripheral (0x40000000), bit-band alias (0x42000000) and core peripheral
+ * (0xE0000000) addresses before main(), so the driver, the HAL and the device header run unchanged; stm32f411xe.h in
+ * this directory only turns PRIMASK masking into no-ops. The memory has no side effects: a bit-band alias does not
+ * reach its register and flags never change by themselves. That is enough for a count of the instructions each
+ * operation executes. It replaces hal_uart_driver.c and writes the table to stdout.
+ */
+
+#ifndef HOST_MOCK_H
+#define HOST_MOCK_H
+
+#include <stdint.h>
+
+/* User-space instructions retired when the perf counter is available, else nanoseconds */
+uint32_t host_bench_counter(void);
+/* "instructions" or "ns", whichever host_bench_counter() counts */
+const char *host_bench_unit(void);
+
+#define GPIO_BENCH_COUNTER      host_bench_counter
+#define GPIO_BENCH_UNIT         host_bench_unit()
+#define GPIO_BENCH_REPEAT       0
+
+#endif
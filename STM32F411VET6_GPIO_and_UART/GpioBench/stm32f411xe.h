@@ -0,0 +1,20 @@
+/*
+ * Host mock-register shim for the device header, see host_mock.h.
+ *
+ * Only the host build puts this directory (-I.) ahead of the CMSIS device include directory, so the sources that
+ * include "stm32f411xe.h" by name (hal_gpio_driver.h, hal_gpio_fast.h, hal_dwt_delay.h) get the real register
+ * definitions followed by the replacements below. The Cortex-M PRIMASK instructions do not assemble on the host.
+ */
+
+#include_next "stm32f411xe.h"
+
+#ifndef HOST_STM32F411XE_HOOKS_H
+#define HOST_STM32F411XE_HOOKS_H
+
+/* No interrupt ever runs on the mock registers, masking is a no-op */
+#define __disable_irq()     ((void)0)
+#define __enable_irq()      ((void)0)
+#define __get_PRIMASK()     (0U)
+#define __set_PRIMASK(x)    ((void)(x))
+
+#endif
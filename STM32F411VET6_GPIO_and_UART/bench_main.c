@@ -0,0 +1,81 @@
+// bench_main.c
+//
+// GPIO micro-benchmark firmware (GPIO_Bench Keil target, GpioBench/Makefile for GCC and the host build).
+// Measures every GPIO operation of the custom driver, its inline fast paths, the ST HAL and the LED layer,
+// and prints the table over USART2 (115200 8N1) every few seconds.
+
+#include "led.h"
+#include "board.h"
+#include "hal_uart_driver.h"
+#include "hal_dwt_delay.h"
+#include "gpio_bench.h"
+
+#ifdef GPIO_BENCH_HOST
+#include "host_mock.h"          // Counter, unit and single run of the host mock-register build
+#else
+// DWT cycle counter, through a function so the bench can call it by pointer
+static uint32_t bench_cycles(void)
+{
+    return hal_dwt_get_cycles();
+}
+
+#define GPIO_BENCH_COUNTER      bench_cycles
+#define GPIO_BENCH_UNIT         "cycles"
+#define GPIO_BENCH_REPEAT       1
+#endif
+
+#define GPIO_BENCH_PERIOD_MS    5000U
+
+static void bench_led_toggle(void)
+{
+    led_toggle(GPIOD, LED_GREEN);
+}
+
+static void bench_led_turn_on(void)
+{
+    led_turn_on(GPIOD, LED_GREEN);
+}
+
+static void bench_led_toggle_mask(void)
+{
+    led_toggle_mask(GPIOD, LED_ALL_MASK);
+}
+
+static void bench_led_green_toggle(void)
+{
+    led_green_toggle();
+}
+
+static const gpio_bench_case_t bench_led_cases[] =
+{
+    { "led_toggle",                     bench_led_toggle },
+    { "led_toggle_mask (4 LEDs)",       bench_led_toggle_mask },
+    { "led_turn_on",                    bench_led_turn_on },
+    { "led_green_toggle",               bench_led_green_toggle },
+};
+
+int main(void)
+{
+    gpio_bench_t bench = { GPIO_BENCH_COUNTER, GPIO_BENCH_UNIT, uart_send_bytes, GPIO_BENCH_RUNS, 0 };
+
+    board_init();   // LEDs and USART2 pins
+    uart_init();    // Also starts the cycle counter
+
+    while (1)
+    {
+        gpio_bench_begin(&bench);
+        gpio_bench_section(&bench, "Custom driver", gpio_bench_driver_cases, gpio_bench_driver_case_count);
+        gpio_bench_section(&bench, "Inline fast paths", gpio_bench_fast_cases, gpio_bench_fast_case_count);
+        gpio_bench_section(&bench, "ST HAL", gpio_bench_hal_cases, gpio_bench_hal_case_count);
+        gpio_bench_section(&bench, "LED layer", bench_led_cases, sizeof(bench_led_cases) / sizeof(bench_led_cases[0]));
+        uart_send_string("\r\n");
+
+        if (!GPIO_BENCH_REPEAT)
+        {
+            break;
+        }
+        hal_dwt_delay_ms(GPIO_BENCH_PERIOD_MS);
+    }
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "board.h"
+#include "led.h"
+
+/* USART2 pins */
+#define USART2_TX_PIN       2
+#define USART2_RX_PIN       3
+#define GPIO_AF7_USART2     7
+
+/**
+  * @brief   Board pin table
+  *          { port, { pin, mode, op_type, pull, speed, alternate } }
+  */
+
+const gpio_board_pin_t board_pins[] =
+{
+	/* User LEDs */
+	{ GPIOD, { LED_GREEN,  GPIO_PIN_OUTPUT_MODE,  GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED,  0 } },
+	{ GPIOD, { LED_ORANGE, GPIO_PIN_OUTPUT_MODE,  GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED,  0 } },
+	{ GPIOD, { LED_RED,    GPIO_PIN_OUTPUT_MODE,  GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED,  0 } },
+	{ GPIOD, { LED_BLUE,   GPIO_PIN_OUTPUT_MODE,  GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED,  0 } },
+	
+	/* User button on PA0, pulled down on the board */
+	{ GPIO_BUTTON_PORT, { GPIO_BUTTON_PIN, GPIO_PIN_INPUT_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_LOW, 0 } },
+	
+	/* USART2 TX/RX */
+	{ GPIOA, { USART2_TX_PIN, GPIO_PIN_ALT_FUN_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_HIGH, GPIO_AF7_USART2 } },
+	{ GPIOA, { USART2_RX_PIN, GPIO_PIN_ALT_FUN_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_PULL_UP,      GPIO_PIN_SPEED_HIGH, GPIO_AF7_USART2 } },
+};
+
+const uint32_t board_pin_count = sizeof(board_pins) / sizeof(board_pins[0]);
+
+/**
+  * @brief   Configures every board pin and enables the clocks of their ports
+  * @param   None
+  * @retval  None
+  */
+
+void board_init(void)
+{
+	hal_gpio_init_board(board_pins, board_pin_count);
+}
@@ -0,0 +1,16 @@
+#ifndef  __BOARD_H
+#define  __BOARD_H
+
+#include "hal_gpio_driver.h"
+
+
+/* Every pin the application uses, configured in one pass per port by board_init() */
+extern const gpio_board_pin_t board_pins[];
+extern const uint32_t board_pin_count;
+
+
+ void board_init(void);
+
+
+
+#endif
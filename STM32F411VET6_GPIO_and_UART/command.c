@@ -0,0 +1,152 @@
+#include "command.h"
+#include <string.h>
+
+/**
+  * @brief   Splits a line into tokens in place, separators (space, tab) become NULs
+  * @param   *line : line to split, modified
+  * @param   **argv: token pointers into line
+  * @param   max   : size of argv
+  * @retval  uint8_t: number of tokens, max + 1 if there are more
+  */
+
+static uint8_t cmd_tokenize(char *line, char **argv, uint8_t max)
+{
+	uint8_t argc = 0;
+
+	while (1)
+	{
+		while (*line == ' ' || *line == '\t')
+			line++;
+		if (*line == '\0')
+			return argc;
+		if (argc == max)
+			return max + 1;
+
+		argv[argc++] = line;
+		while (*line != '\0' && *line != ' ' && *line != '\t')
+			line++;
+		if (*line != '\0')
+			*line++ = '\0';
+	}
+}
+
+/**
+  * @brief   Checks that the verbs of a table are in strictly ascending strcmp() order, as cmd_find() needs
+  * @param   *table: command table
+  * @retval  uint8_t: 1 if sorted, 0 otherwise
+  */
+
+uint8_t cmd_table_check(const cmd_table_t *table)
+{
+	uint32_t i;
+
+	for (i = 1; i < table->count; i++)
+	{
+		if (strcmp(table->entries[i - 1].verb, table->entries[i].verb) >= 0)
+			return 0;
+	}
+	return 1;
+}
+
+/**
+  * @brief   Looks up a verb, binary search: log2(n) + 1 string compares at most
+  * @param   *table: command table, sorted
+  * @param   *verb : verb to find
+  * @retval  const cmd_entry_t*: entry, NULL if the verb is unknown
+  */
+
+const cmd_entry_t *cmd_find(const cmd_table_t *table, const char *verb)
+{
+	uint32_t lo = 0, hi = table->count, mid;
+	int cmp;
+
+	while (lo < hi)
+	{
+		mid = (lo + hi) / 2;
+		cmp = strcmp(verb, table->entries[mid].verb);
+		if (cmp == 0)
+			return &table->entries[mid];
+		if (cmp < 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return 0;
+}
+
+/**
+  * @brief   Runs one command line
+  * @param   *table: command table, sorted
+  * @param   *line : NUL terminated line, split in place
+  * @param   **reply: reply of the handler, NULL unless the status is CMD_OK and the handler has one
+  * @retval  cmd_status_t: CMD_OK when the handler ran
+  */
+
+cmd_status_t cmd_dispatch(const cmd_table_t *table, char *line, const char **reply)
+{
+	char *argv[CMD_MAX_ARGS + 1];
+	cmd_args_t args = { { 0 }, 0 };
+	const cmd_entry_t *cmd;
+	uint8_t argc = cmd_tokenize(line, argv, CMD_MAX_ARGS + 1);
+
+	*reply = 0;
+	if (argc == 0)
+		return CMD_EMPTY;
+
+	cmd = cmd_find(table, argv[0]);
+	if (cmd == 0)
+		return CMD_UNKNOWN;
+	if (argc > CMD_MAX_ARGS + 1)
+		return CMD_BAD_ARGS;
+
+	args.count = argc - 1;
+	if (!cmd->parse(&argv[1], args.count, &args))
+		return CMD_BAD_ARGS;
+
+	*reply = cmd->handler(&args);
+	return CMD_OK;
+}
+
+/**
+  * @brief   Parser of verbs without arguments
+  * @param   **argv: argument tokens
+  * @param   argc  : number of tokens
+  * @param   *args : converted arguments
+  * @retval  uint8_t: 1 if there is no argument
+  */
+
+uint8_t cmd_parse_none(char **argv, uint8_t argc, cmd_args_t *args)
+{
+	(void)argv;
+	(void)args;
+	return argc == 0;
+}
+
+/**
+  * @brief   Parser of one unsigned decimal number, into value[0]
+  * @param   **argv: argument tokens
+  * @param   argc  : number of tokens
+  * @param   *args : converted arguments
+  * @retval  uint8_t: 1 for exactly one number that fits 32 bits
+  */
+
+uint8_t cmd_parse_u32(char **argv, uint8_t argc, cmd_args_t *args)
+{
+	const char *p;
+	uint32_t value = 0, digit;
+
+	if (argc != 1 || *argv[0] == '\0')
+		return 0;
+
+	for (p = argv[0]; *p != '\0'; p++)
+	{
+		if (*p < '0' || *p > '9')
+			return 0;
+		digit = (uint32_t)(*p - '0');
+		if (value > (0xFFFFFFFFU - digit) / 10U)
+			return 0;
+		value = value * 10U + digit;
+	}
+	args->value[0] = value;
+	return 1;
+}
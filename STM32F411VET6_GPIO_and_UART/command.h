@@ -0,0 +1,73 @@
+#ifndef  __COMMAND_H
+#define  __COMMAND_H
+
+#include <stdint.h>
+
+
+/*
+ *  Declarative command tables. A line is split in place into a verb and its arguments (separators become NULs, the
+ *  line is never copied), the verb is found by binary search in a table sorted by strcmp() order, the entry's parser
+ *  converts the argument tokens and its handler runs. Adding a verb is one table row:
+ *
+ *      static const cmd_entry_t app_cmds[] =
+ *      {
+ *          { "BAUD",     cmd_parse_u32,  app_baud },        strcmp() order
+ *          { "LED_ON",   app_parse_leds, app_led_on },
+ *      };
+ *      CMD_TABLE(app_table, app_cmds);
+ *
+ *      cmd_dispatch(&app_table, line, &reply);
+ */
+
+#define CMD_MAX_ARGS    4       /* Argument tokens after the verb */
+
+/* Arguments as converted by the parser of the verb */
+typedef struct
+{
+	uint32_t value[CMD_MAX_ARGS];
+	uint8_t count;              /* Argument tokens on the line */
+} cmd_args_t;
+
+/* Parser: argv holds the argc tokens after the verb, returns 0 to refuse them */
+typedef uint8_t (*cmd_parser_t)(char **argv, uint8_t argc, cmd_args_t *args);
+
+/* Handler: returns the reply to send, NULL for none */
+typedef const char *(*cmd_handler_t)(const cmd_args_t *args);
+
+typedef struct
+{
+	const char *verb;
+	cmd_parser_t parse;
+	cmd_handler_t handler;
+} cmd_entry_t;
+
+typedef struct
+{
+	const cmd_entry_t *entries; /* Sorted by verb, strcmp() order */
+	uint32_t count;
+} cmd_table_t;
+
+#define CMD_TABLE(name, entries)    const cmd_table_t name = { entries, sizeof(entries) / sizeof(entries[0]) }
+
+typedef enum
+{
+	CMD_OK = 0,
+	CMD_EMPTY,                  /* Nothing but separators */
+	CMD_UNKNOWN,                /* Verb not in the table */
+	CMD_BAD_ARGS,               /* Too many tokens or refused by the parser */
+} cmd_status_t;
+
+
+ uint8_t cmd_table_check(const cmd_table_t *table);
+
+ const cmd_entry_t *cmd_find(const cmd_table_t *table, const char *verb);
+
+ cmd_status_t cmd_dispatch(const cmd_table_t *table, char *line, const char **reply);
+
+ uint8_t cmd_parse_none(char **argv, uint8_t argc, cmd_args_t *args);
+
+ uint8_t cmd_parse_u32(char **argv, uint8_t argc, cmd_args_t *args);
+
+
+
+#endif
@@ -1,11 +1,52 @@
 // hal_uart_driver.c
 
 #include "hal_uart_driver.h"
+#include "hal_dwt_delay.h"
+#include "hal_gpio_driver.h"
 #include "stm32f411xe.h"    
 
+// Rings: head is written only by the producer, tail only by the consumer. Indices run freely and wrap at 2^32,
+// head - tail is the fill level and index & (SIZE - 1) the slot.
+static volatile uint8_t uart_tx_buf[UART_TX_RING_SIZE];
+static volatile uint32_t uart_tx_head;      // Main loop
+static volatile uint32_t uart_tx_tail;      // DMA1 Stream6 interrupt
+static volatile uint8_t uart_rx_buf[UART_RX_RING_SIZE];
+static volatile uint32_t uart_rx_head;      // USART2 interrupt
+static volatile uint32_t uart_rx_tail;      // Main loop
+static volatile uint32_t uart_rx_lost;      // USART2 interrupt
+static uint32_t uart_rx_skipped;            // Main loop, bytes DMA overwrote before they were read
+static uart_rx_callback_t uart_rx_callback; // DMA mode only
+
+// Transmit descriptors, same ownership rules as the rings. The descriptor at the tail is the one DMA is sending.
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t len;
+    uart_tx_done_t done;
+} uart_tx_desc_t;
+
+static uart_tx_desc_t uart_tx_queue[UART_TX_QUEUE_LEN];
+static volatile uint32_t uart_tx_queue_head; // Main loop
+static volatile uint32_t uart_tx_queue_tail; // DMA1 Stream6 interrupt
+
+// Line being assembled by uart_read_line()
+static uint32_t uart_line_len;
+
+// Interrupt enables, bit-band stores so they never race the interrupt's own changes to CR1
+#define UART_RXNEIE   HAL_BITBAND_PERIPH(USART2->CR1, USART_CR1_RXNEIE_Pos)
+#define UART_IDLEIE   HAL_BITBAND_PERIPH(USART2->CR1, USART_CR1_IDLEIE_Pos)
+
+// DMA1 Stream5 flags in HISR/HIFCR
+#define UART_RX_DMA_FLAGS   (DMA_HIFCR_CFEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTCIF5)
+// DMA1 Stream6 flags in HISR/HIFCR
+#define UART_TX_DMA_FLAGS   (DMA_HIFCR_CFEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CTEIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTCIF6)
+
 // UART initialization
 void uart_init(void)
 {
+	    // Cycle counter timebase for the TX timeouts
+    hal_dwt_init();
+
 	    // Enable UART clock
     RCC->APB1ENR |= RCC_APB1ENR_USART2EN;
     
@@ -15,8 +56,31 @@ void uart_init(void)
     GPIOA->AFR[0] |= (7 << 8) | (7 << 12);  // AF7 for USART2
 
     // Configure UART
-    USART2->BRR = SystemCoreClock / 115200;
-    USART2->CR1 = USART_CR1_TE | USART_CR1_RE | USART_CR1_UE;
+    uart_tx_head = uart_tx_tail = 0;
+    uart_rx_head = uart_rx_tail = 0;
+    uart_rx_lost = 0;
+    uart_rx_skipped = 0;
+    uart_line_len = 0;
+    uart_tx_queue_head = uart_tx_queue_tail = 0;
+
+    // Transmit DMA, memory to USART2 DR; each descriptor sets the address and count and enables the stream
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+    UART_TX_DMA_STREAM->CR = 0;
+    while (UART_TX_DMA_STREAM->CR & DMA_SxCR_EN);
+    DMA1->HIFCR = UART_TX_DMA_FLAGS;
+    UART_TX_DMA_STREAM->PAR = (uint32_t)&USART2->DR;
+    UART_TX_DMA_STREAM->FCR = 0;         // Direct mode
+    UART_TX_DMA_STREAM->CR = (UART_TX_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_DIR_0 | DMA_SxCR_MINC
+                           | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    NVIC_SetPriority(UART_TX_DMA_IRQn, UART_IRQ_PRIORITY);
+    NVIC_EnableIRQ(UART_TX_DMA_IRQn);
+
+    // Receive interrupt on, transmission goes through DMA
+    USART2->CR3 = USART_CR3_DMAT;
+    USART2->CR1 = USART_CR1_TE | USART_CR1_RE | USART_CR1_RXNEIE;
+    uart_set_baud(UART_BAUD);            // Enables the USART
+    NVIC_SetPriority(USART2_IRQn, UART_IRQ_PRIORITY);
+    NVIC_EnableIRQ(USART2_IRQn);
 	
 	
 	
@@ -35,31 +99,416 @@ void uart_init(void)
 //    USART2->CR1 |= USART_CR1_TE | USART_CR1_RE | USART_CR1_UE;  // Enable TX, RX, and USART
 }
 
+// PPRE1 field: 0xx = HCLK, 100 = HCLK / 2, 101 = / 4, 110 = / 8, 111 = / 16
+uint32_t uart_pclk(void)
+{
+    uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+
+    SystemCoreClockUpdate();             // HCLK from the clock source, PLL and AHB prescaler in use
+    return (ppre1 & 4U) ? SystemCoreClock >> ((ppre1 & 3U) + 1U) : SystemCoreClock;
+}
+
+// pclk / baud is USARTDIV in 1/16 units with OVER8 = 0 and in 1/8 units with OVER8 = 1, so one rounded division
+// gives the divider for both; only the BRR encoding differs (OVER8 keeps a 3-bit fraction in BRR[2:0]).
+// Returns 0 when the rate is out of range.
+static uint32_t uart_baud_divider(uint32_t pclk, uint32_t baud)
+{
+    uint32_t div;
+
+    if (!baud)
+        return 0;
+    div = (pclk + baud / 2U) / baud;
+    if (div < 8U || div > 0xFFFFU)       // USARTDIV >= 1 with 8x oversampling, 12-bit mantissa with 16x
+        return 0;
+    return div;
+}
+
+// Rate error of a divider in ppm
+static int32_t uart_baud_ppm(uint32_t pclk, uint32_t baud, uint32_t div)
+{
+    return (int32_t)(((int64_t)pclk - (int64_t)div * baud) * 1000000 / ((int64_t)div * baud));
+}
+
+int32_t uart_baud_error(uint32_t baud)
+{
+    uint32_t pclk = uart_pclk();
+    uint32_t div = uart_baud_divider(pclk, baud);
+
+    return div ? uart_baud_ppm(pclk, baud, div) : UART_BAUD_INVALID;
+}
+
+int32_t uart_set_baud(uint32_t baud)
+{
+    uint32_t pclk = uart_pclk();
+    uint32_t div = uart_baud_divider(pclk, baud);
+    uint32_t cr1, tail, left;
+    hal_dwt_deadline_t stall;
+
+    if (!div)
+        return UART_BAUD_INVALID;
+
+    // OVER8 may only change with the USART disabled, let everything queued leave at the old rate first. A transfer
+    // that stops moving for UART_TX_TIMEOUT_US (stream stalled, TX disabled) leaves the rate unchanged.
+    cr1 = USART2->CR1;
+    if (cr1 & USART_CR1_UE)
+    {
+        tail = uart_tx_queue_tail;
+        left = UART_TX_DMA_STREAM->NDTR;
+        hal_dwt_deadline_set(&stall, UART_TX_TIMEOUT_US);
+        while (uart_tx_queue_tail != uart_tx_queue_head)
+        {
+            if (uart_tx_queue_tail != tail || UART_TX_DMA_STREAM->NDTR != left)
+            {
+                tail = uart_tx_queue_tail;   // Still sending, each character restarts the wait
+                left = UART_TX_DMA_STREAM->NDTR;
+                hal_dwt_deadline_set(&stall, UART_TX_TIMEOUT_US);
+            }
+            else if (hal_dwt_deadline_expired(&stall))
+                return UART_BAUD_TIMEOUT;
+        }
+        hal_dwt_deadline_set(&stall, 2U * UART_TX_TIMEOUT_US);   // Up to two characters left, in DR and shifting
+        while (!(USART2->SR & USART_SR_TC))
+        {
+            if (hal_dwt_deadline_expired(&stall))
+                return UART_BAUD_TIMEOUT;
+        }
+    }
+    USART2->CR1 = cr1 & ~USART_CR1_UE;
+    if (div >= 16U)
+    {
+        USART2->BRR = div;
+        cr1 &= ~USART_CR1_OVER8;
+    }
+    else
+    {
+        USART2->BRR = ((div >> 3) << 4) | (div & 7U);
+        cr1 |= USART_CR1_OVER8;
+    }
+    USART2->CR1 = cr1 | USART_CR1_UE;
+
+    return uart_baud_ppm(pclk, baud, div);
+}
+
+// Completion of a region of the TX ring, the slots go back to uart_write(). Ring regions complete in order.
+static void uart_tx_ring_done(const uint8_t *data, uint32_t len)
+{
+    (void)data;
+    uart_tx_tail += len;
+}
+
+// Queue bytes for transmission, returns how many fit
+uint32_t uart_write(const uint8_t *data, uint32_t len)
+{
+    uint32_t head = uart_tx_head;
+    uint32_t slot = head & (UART_TX_RING_SIZE - 1);
+    uint32_t room = UART_TX_RING_SIZE - (head - uart_tx_tail);
+    uint32_t n;
+
+    if (room > UART_TX_RING_SIZE - slot) // One descriptor per contiguous region, a wrapped rest takes the next call
+        room = UART_TX_RING_SIZE - slot;
+    if (len > room)
+        len = room;
+    if (!len || !uart_tx_queue_free())
+        return 0;
+    for (n = 0; n < len; n++)
+        uart_tx_buf[slot + n] = data[n];
+
+    uart_tx_head = head + len;
+    uart_tx_submit((const uint8_t *)&uart_tx_buf[slot], len, uart_tx_ring_done);
+    return len;
+}
+
+// Queue a descriptor; the DMA interrupt is pended to start it when the stream is idle, so only the interrupt ever
+// starts a transfer and the main loop never races it
+uint8_t uart_tx_submit(const uint8_t *data, uint32_t len, uart_tx_done_t done)
+{
+    uint32_t head = uart_tx_queue_head;
+    uart_tx_desc_t *desc;
+
+    if (head - uart_tx_queue_tail >= UART_TX_QUEUE_LEN || len > 0xFFFFU)  // NDTR is 16 bits
+        return 0;
+    desc = &uart_tx_queue[head & (UART_TX_QUEUE_LEN - 1)];
+    desc->data = data;
+    desc->len = len;
+    desc->done = done;
+    uart_tx_queue_head = head + 1;       // Publish after the descriptor, both are volatile so the order is kept
+
+    if (!(UART_TX_DMA_STREAM->CR & DMA_SxCR_EN))
+        NVIC_SetPendingIRQ(UART_TX_DMA_IRQn);
+    return 1;
+}
+
+uint32_t uart_tx_queue_free(void)
+{
+    return UART_TX_QUEUE_LEN - (uart_tx_queue_head - uart_tx_queue_tail);
+}
+
+// Take received bytes, returns how many were available
+uint32_t uart_read(uint8_t *data, uint32_t len)
+{
+    uint32_t head = uart_rx_head;
+    uint32_t tail = uart_rx_tail;
+    uint32_t avail = head - tail;
+    uint32_t n;
+
+    if (avail > UART_RX_RING_SIZE)       // DMA mode never waits for the reader, keep the newest ring full
+    {
+        uart_rx_skipped += avail - UART_RX_RING_SIZE;
+        tail = head - UART_RX_RING_SIZE;
+        avail = UART_RX_RING_SIZE;
+    }
+    if (len > avail)
+        len = avail;
+    for (n = 0; n < len; n++)
+        data[n] = uart_rx_buf[(tail + n) & (UART_RX_RING_SIZE - 1)];
+
+    uart_rx_tail = tail + len;           // Slots go back to the interrupt only after they are copied
+    return len;
+}
+
+uint32_t uart_tx_free(void)
+{
+    return UART_TX_RING_SIZE - (uart_tx_head - uart_tx_tail);
+}
+
+uint32_t uart_rx_available(void)
+{
+    uint32_t avail = uart_rx_head - uart_rx_tail;
+
+    return avail > UART_RX_RING_SIZE ? UART_RX_RING_SIZE : avail;
+}
+
+uint32_t uart_rx_dropped(void)
+{
+    return uart_rx_lost + uart_rx_skipped;
+}
+
+// Publish the bytes DMA wrote since the last IDLE, half or full transfer event. USART2 and DMA1 Stream5 share one
+// priority, so this never preempts itself; events come at least every half ring, so at most a half ring is new.
+static void uart_rx_dma_publish(void)
+{
+    uint32_t pos = (UART_RX_RING_SIZE - UART_RX_DMA_STREAM->NDTR) & (UART_RX_RING_SIZE - 1);
+    uint32_t last = uart_rx_head & (UART_RX_RING_SIZE - 1);
+    uint32_t len = (pos - last) & (UART_RX_RING_SIZE - 1);
+
+    if (!len)
+        return;
+    if (uart_rx_callback)
+    {
+        if (pos > last)
+        {
+            uart_rx_callback((const uint8_t *)&uart_rx_buf[last], len);
+        }
+        else
+        {
+            uart_rx_callback((const uint8_t *)&uart_rx_buf[last], UART_RX_RING_SIZE - last);
+            if (pos)
+                uart_rx_callback((const uint8_t *)&uart_rx_buf[0], pos);
+        }
+    }
+    uart_rx_head += len;
+}
+
+// DMA circular reception into the RX ring
+void uart_rx_dma_start(uart_rx_callback_t callback)
+{
+    DMA_Stream_TypeDef *stream = UART_RX_DMA_STREAM;
+
+    UART_RXNEIE = 0;
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+    stream->CR &= ~DMA_SxCR_EN;
+    while (stream->CR & DMA_SxCR_EN);
+
+    // DMA fills the ring from slot 0, the indices restart there
+    uart_rx_callback = callback;
+    uart_rx_head = uart_rx_tail = 0;
+    uart_line_len = 0;
+
+    DMA1->HIFCR = UART_RX_DMA_FLAGS;
+    stream->PAR = (uint32_t)&USART2->DR;
+    stream->M0AR = (uint32_t)uart_rx_buf;
+    stream->NDTR = UART_RX_RING_SIZE;
+    stream->FCR = 0;                     // Direct mode, bytes in and out
+    stream->CR = (UART_RX_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_MINC | DMA_SxCR_CIRC
+               | DMA_SxCR_HTIE | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    NVIC_SetPriority(UART_RX_DMA_IRQn, UART_IRQ_PRIORITY);
+    NVIC_EnableIRQ(UART_RX_DMA_IRQn);
+    (void)USART2->SR;                    // Drop a stale IDLE flag before the stream can take DR
+    (void)USART2->DR;
+    stream->CR |= DMA_SxCR_EN;
+
+    USART2->CR3 |= USART_CR3_DMAR;
+    UART_IDLEIE = 1;
+}
+
+// Back to the receive interrupt, bytes already published stay in the ring
+void uart_rx_dma_stop(void)
+{
+    DMA_Stream_TypeDef *stream = UART_RX_DMA_STREAM;
+
+    UART_IDLEIE = 0;
+    NVIC_DisableIRQ(UART_RX_DMA_IRQn);
+    USART2->CR3 &= ~USART_CR3_DMAR;
+    stream->CR &= ~DMA_SxCR_EN;
+    while (stream->CR & DMA_SxCR_EN);
+    DMA1->HIFCR = UART_RX_DMA_FLAGS;
+
+    uart_rx_dma_publish();               // Whatever arrived since the last event
+    uart_rx_callback = 0;
+    UART_RXNEIE = 1;
+}
+
+// Assemble a line from whatever has arrived, never waits
+uint8_t uart_read_line(char *buffer, uint32_t max_len)
+{
+    uint8_t ch;
+
+    while (uart_read(&ch, 1))
+    {
+        if (ch == '\n' || ch == '\r')  // Line complete, empty lines (e.g. the \n of a \r\n) are skipped
+        {
+            if (uart_line_len == 0)
+                continue;
+            buffer[uart_line_len] = '\0';
+            uart_line_len = 0;
+            return 1;
+        }
+        if (uart_line_len < max_len - 1)  // Leave space for null terminator, the rest of a long line is dropped
+            buffer[uart_line_len++] = (char)ch;
+    }
+    return 0;
+}
+
+// Send binary data over UART
+void uart_send_bytes(const uint8_t *data, uint32_t len)
+{
+    hal_dwt_deadline_t stall;
+    uint32_t n;
+
+    hal_dwt_deadline_set(&stall, UART_TX_TIMEOUT_US);
+    while (len)
+    {
+        n = uart_write(data, len);
+        data += n;
+        len -= n;
+        if (n)
+            hal_dwt_deadline_set(&stall, UART_TX_TIMEOUT_US);
+        else if (hal_dwt_deadline_expired(&stall))  // Give up if the transmitter is stuck
+            return;
+    }
+}
+
 // Send a string over UART
 void uart_send_string(const char *str)
 {
-    while (*str)
+    const char *end = str;
+
+    while (*end)
+        end++;
+    uart_send_bytes((const uint8_t *)str, (uint32_t)(end - str));
+}
+
+// Send a constant string without copying it
+void uart_send_static(const char *str)
+{
+    hal_dwt_deadline_t stall;
+    const char *end = str;
+
+    while (*end)
+        end++;
+    hal_dwt_deadline_set(&stall, UART_TX_TIMEOUT_US);
+    while (!uart_tx_submit((const uint8_t *)str, (uint32_t)(end - str), 0))
     {
-        while (!(USART2->SR & USART_SR_TXE));  // Wait until TX buffer is empty
-        USART2->DR = *str++;                   // Send character
+        if (hal_dwt_deadline_expired(&stall))
+            return;
     }
 }
 
 // Receive a string over UART
 void uart_receive_string(char *buffer, int max_len)
 {
-    int i = 0;
-    char ch;
+    while (!uart_read_line(buffer, (uint32_t)max_len))
+        __WFI();                         // Woken by the receive interrupt
+}
+
+// Moves one received byte per interrupt into the RX ring. In DMA mode only IDLE is enabled.
+void USART2_IRQHandler(void)
+{
+    uint32_t sr = USART2->SR;
+    uint32_t head;
+    uint8_t ch;
 
-    while (i < max_len - 1)  // Leave space for null terminator
+    if ((sr & (USART_SR_RXNE | USART_SR_ORE)) && UART_RXNEIE)
     {
-        while (!(USART2->SR & USART_SR_RXNE));  // Wait until data is received
-        ch = USART2->DR;  // Read the received character
+        ch = (uint8_t)USART2->DR;        // SR then DR read also clears ORE
+        if (sr & USART_SR_ORE)
+            uart_rx_lost++;
+        head = uart_rx_head;
+        if (head - uart_rx_tail < UART_RX_RING_SIZE)
+        {
+            uart_rx_buf[head & (UART_RX_RING_SIZE - 1)] = ch;
+            uart_rx_head = head + 1;
+        }
+        else
+        {
+            uart_rx_lost++;
+        }
+    }
 
-        if (ch == '\n' || ch == '\r')  // Stop reading at newline
-            break;
+    if ((sr & USART_SR_IDLE) && UART_IDLEIE)
+    {
+        (void)USART2->DR;                // SR then DR read clears IDLE, DMA has already taken the data
+        uart_rx_dma_publish();
+    }
+}
+
+// DMA1 Stream5: the RX ring is half or completely full since the last event
+void DMA1_Stream5_IRQHandler(void)
+{
+    uint32_t flags = DMA1->HISR;
 
-        buffer[i++] = ch;  // Store received character in buffer
+    DMA1->HIFCR = UART_RX_DMA_FLAGS;
+    if (flags & DMA_HISR_TEIF5)          // Bus error has stopped the stream, fall back to the receive interrupt
+    {
+        uart_rx_lost++;
+        uart_rx_dma_stop();
+        return;
+    }
+    uart_rx_dma_publish();
+}
+
+// DMA1 Stream6: the descriptor at the tail has been sent (or pended by uart_tx_submit() on an idle stream). The next
+// one starts here, while USART2 still shifts out the last byte.
+void DMA1_Stream6_IRQHandler(void)
+{
+    uint32_t flags = DMA1->HISR;
+    uint32_t tail = uart_tx_queue_tail;
+    uart_tx_desc_t *desc;
+
+    DMA1->HIFCR = UART_TX_DMA_FLAGS;
+    if (flags & (DMA_HISR_TCIF6 | DMA_HISR_TEIF6))  // A bus error also ends the descriptor, the data is lost
+    {
+        desc = &uart_tx_queue[tail & (UART_TX_QUEUE_LEN - 1)];
+        uart_tx_queue_tail = ++tail;
+        if (desc->done)
+            desc->done(desc->data, desc->len);
+    }
+
+    if (UART_TX_DMA_STREAM->CR & DMA_SxCR_EN)
+        return;
+    while (tail != uart_tx_queue_head)
+    {
+        desc = &uart_tx_queue[tail & (UART_TX_QUEUE_LEN - 1)];
+        if (desc->len)
+        {
+            UART_TX_DMA_STREAM->M0AR = (uint32_t)desc->data;
+            UART_TX_DMA_STREAM->NDTR = desc->len;
+            USART2->SR = ~(uint32_t)USART_SR_TC;  // rc_w0, DMA writes to DR never clear TC, uart_set_baud() waits for it
+            UART_TX_DMA_STREAM->CR |= DMA_SxCR_EN;
+            return;
+        }
+        uart_tx_queue_tail = ++tail;     // Nothing to send, complete at once
+        if (desc->done)
+            desc->done(desc->data, desc->len);
     }
-    buffer[i] = '\0';  // Null-terminate the string
 }
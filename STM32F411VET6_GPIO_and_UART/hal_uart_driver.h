@@ -3,9 +3,88 @@
 #ifndef HAL_UART_DRIVER_H
 #define HAL_UART_DRIVER_H
 
+#include <stdint.h>
+
+// Line rate set by uart_init(), uart_set_baud() changes it later. USART2 runs from PCLK1 and reaches PCLK1 / 8:
+// 2 Mbaud from the 16 MHz HSI, 3 Mbaud needs PCLK1 >= 24 MHz.
+#define UART_BAUD            115200U
+
+// uart_set_baud() result for a rate PCLK1 cannot produce
+#define UART_BAUD_INVALID    INT32_MIN
+// uart_set_baud() result when the queued data stopped leaving at the old rate, the rate is unchanged
+#define UART_BAUD_TIMEOUT    (INT32_MIN + 1)
+
+// Longest wait for room in the TX ring before uart_send_* drops the rest (one character at 1200 baud is ~8.3 ms)
+#define UART_TX_TIMEOUT_US   10000
+
+// USART2 is interrupt driven: the interrupts move bytes between the data register and two rings, the main loop only
+// copies to and from the rings. Each ring has one producer and one consumer (main loop and an interrupt), which
+// each own one index, so no lock and no interrupt masking is needed. Sizes must be powers of two.
+#define UART_TX_RING_SIZE    256U
+#define UART_RX_RING_SIZE    512U
+#define UART_IRQ_PRIORITY    4U
+
+// DMA receive mode: DMA1 Stream5 channel 4 writes every received byte straight into the RX ring, circular. The USART
+// IDLE interrupt (end of a frame) and the DMA half/full transfer interrupts publish what has arrived, so there is no
+// interrupt per byte. The ring only has to be emptied within UART_RX_RING_SIZE / 2 character times, 850 us at 3 Mbaud.
+#define UART_RX_DMA_STREAM   DMA1_Stream5
+#define UART_RX_DMA_IRQn     DMA1_Stream5_IRQn
+#define UART_RX_DMA_CHANNEL  4U
+
+// Transmission: DMA1 Stream6 channel 4 sends a queue of descriptors (pointer, length, completion callback) back to
+// back, the next one is started from the transfer complete interrupt while the last byte is still in the shifter, so
+// frames follow each other without a gap. uart_write() copies into the TX ring and queues the copied region; constant
+// data and buffers lent with uart_tx_submit() are sent in place. The queue is filled from the main loop only.
+#define UART_TX_QUEUE_LEN    16U
+#define UART_TX_DMA_STREAM   DMA1_Stream6
+#define UART_TX_DMA_IRQn     DMA1_Stream6_IRQn
+#define UART_TX_DMA_CHANNEL  4U
+
+// Called from interrupt context with each newly received region of the RX ring, twice when the region wraps
+typedef void (*uart_rx_callback_t)(const uint8_t *data, uint32_t len);
+
+// Called from interrupt context once a submitted buffer has been sent, it belongs to the caller again
+typedef void (*uart_tx_done_t)(const uint8_t *data, uint32_t len);
+
 // Function declarations for UART
 void uart_init(void);
+
+// Baud rate generator. USARTDIV is rounded to the nearest 1/16 (OVER8 = 0, used whenever PCLK1 >= 16 x baud for its
+// better noise margin) or 1/8 (OVER8 = 1, up to PCLK1 / 8); both round to the same divider, so the rate error is the
+// same. Returns the achieved error in ppm (achieved - requested), UART_BAUD_INVALID if out of range. Waits until
+// everything queued has been sent at the old rate, UART_BAUD_TIMEOUT if it stalls; call from the main loop.
+int32_t uart_set_baud(uint32_t baud);
+int32_t uart_baud_error(uint32_t baud);    // Same result without changing the rate
+uint32_t uart_pclk(void);                  // USART2 clock in Hz: HCLK through the APB1 prescaler, read from RCC
+
+// Non-blocking, return the number of bytes copied (may be less than len, or 0)
+uint32_t uart_write(const uint8_t *data, uint32_t len);
+uint32_t uart_read(uint8_t *data, uint32_t len);
+uint32_t uart_tx_free(void);               // Room left in the TX ring
+uint32_t uart_rx_available(void);          // Bytes waiting in the RX ring
+uint32_t uart_rx_dropped(void);            // Bytes lost to a full RX ring or a receiver overrun since uart_init()
+
+// Collects a line from the RX ring without blocking: returns 1 when buffer holds a complete line (NUL terminated,
+// '\r'/'\n' removed), 0 while it is still incomplete. Pass the same buffer until it returns 1. Longer lines are cut
+// at max_len - 1 characters.
+uint8_t uart_read_line(char *buffer, uint32_t max_len);
+
+// Switch reception to DMA (unread bytes are discarded) or back to one interrupt per byte. callback may be NULL, the
+// data is then taken with uart_read() / uart_read_line() as in interrupt mode.
+void uart_rx_dma_start(uart_rx_callback_t callback);
+void uart_rx_dma_stop(void);
+
+// Zero-copy: queue a buffer of up to 65535 bytes that stays untouched until done() is called (done may be NULL for
+// constant data). Returns 1 when queued, 0 when the descriptor queue is full.
+uint8_t uart_tx_submit(const uint8_t *data, uint32_t len, uart_tx_done_t done);
+uint32_t uart_tx_queue_free(void);         // Descriptors left in the queue
+
+// Queue everything, waiting for room only when the TX ring or the descriptor queue is full
 void uart_send_string(const char *str);
+void uart_send_bytes(const uint8_t *data, uint32_t len);   // Binary data, zero bytes included
+void uart_send_static(const char *str);   // String that never changes (a literal), sent in place
+
+// Blocks until a complete line is received
 void uart_receive_string(char *buffer, int max_len);
 
 #endif  // HAL_UART_DRIVER_H
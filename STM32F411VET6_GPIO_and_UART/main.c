@@ -1,7 +1,170 @@
+#include "led.h"
+#include "board.h"
+#include "hal_uart_driver.h"  // Include the UART driver
+#include "hal_dwt_delay.h"
+#include "hal_gpio_sampler.h"
+#include "command.h"
+#include <string.h>
 
+#define LA_SAMPLE_RATE_HZ    100000U     // Logic capture of the GPIOD LEDs, the button is on GPIOA
+#define LA_CAPTURE_MS        1000U
+#define BAUD_MAX_ERROR_PPM   20000       // Largest rate error BAUD accepts, half the usual receiver tolerance
+
+static hal_dwt_deadline_t la_capture_end;
+static uint8_t la_capturing;            // Set by LA_CAPTURE, cleared by main() when the capture ends
+
+// User button pressed (debounced), called from the debounce timer interrupt
+static void button_pressed(uint16_t pin_no, uint8_t level)
+{
+    led_green_toggle();
+}
+
+// LED names accepted by the LED_* commands
+static const struct
+{
+    const char *name;
+    uint16_t mask;
+} led_names[] =
+{
+    { "all",    LED_ALL_MASK },
+    { "blue",   1U << LED_BLUE },
+    { "green",  1U << LED_GREEN },
+    { "orange", 1U << LED_ORANGE },
+    { "red",    1U << LED_RED },
+};
+
+// One or more LED names, their mask into value[0]
+static uint8_t parse_leds(char **argv, uint8_t argc, cmd_args_t *args)
+{
+    uint32_t i, n;
+
+    if (argc == 0)
+        return 0;
+    args->value[0] = 0;
+    for (i = 0; i < argc; i++)
+    {
+        for (n = 0; n < sizeof(led_names) / sizeof(led_names[0]); n++)
+        {
+            if (strcmp(argv[i], led_names[n].name) == 0)
+                break;
+        }
+        if (n == sizeof(led_names) / sizeof(led_names[0]))
+            return 0;
+        args->value[0] |= led_names[n].mask;
+    }
+    return 1;
+}
+
+static const char *cmd_led_on(const cmd_args_t *args)
+{
+    hal_gpio_set_pins(GPIOD, (uint16_t)args->value[0]);
+    return "OK\n";
+}
+
+static const char *cmd_led_off(const cmd_args_t *args)
+{
+    hal_gpio_clear_pins(GPIOD, (uint16_t)args->value[0]);
+    return "OK\n";
+}
+
+static const char *cmd_led_toggle(const cmd_args_t *args)
+{
+    led_toggle_mask(GPIOD, (uint16_t)args->value[0]);
+    return "OK\n";
+}
+
+// Compressed binary capture, streamed by the main loop for LA_CAPTURE_MS, see hal_gpio_sampler.h for the format
+static const char *cmd_la_capture(const cmd_args_t *args)
+{
+    if (!hal_gpio_sampler_start(GPIOD, LED_ALL_MASK, uart_send_bytes))
+        return "BUSY\n";                // TIM1 is playing a waveform
+    hal_dwt_deadline_set(&la_capture_end, LA_CAPTURE_MS * 1000U);
+    la_capturing = 1;
+    return NULL;                        // "OK" follows the stream once main() stops it
+}
+
+// The reply goes out at the old rate, the host switches after it
+static const char *cmd_baud(const cmd_args_t *args)
+{
+    int32_t error = uart_baud_error(args->value[0]);
+
+    if (error == UART_BAUD_INVALID || error > BAUD_MAX_ERROR_PPM || error < -BAUD_MAX_ERROR_PPM)
+        return "BAD ARGUMENT\n";
+    uart_send_static("OK\n");
+    uart_set_baud(args->value[0]);
+    return 0;
+}
+
+// Sorted by verb (strcmp() order), checked at startup
+static const cmd_entry_t led_cmds[] =
+{
+    { "BAUD",           cmd_parse_u32,      cmd_baud },             // BAUD <rate>
+    { "LA_CAPTURE",     cmd_parse_none,     cmd_la_capture },
+    { "LED_OFF",        parse_leds,         cmd_led_off },          // LED_OFF <colour|all> ...
+    { "LED_ON",         parse_leds,         cmd_led_on },
+    { "LED_TOGGLE",     parse_leds,         cmd_led_toggle },
+};
+static CMD_TABLE(led_cmd_table, led_cmds);
 
 int main(void)
 {
-	
-	return 0;
-}
\ No newline at end of file
+    char command[100];  // To store received command
+    const char *reply;
+
+    board_init();  // LEDs, button and USART2 pins
+    uart_init();  // Initialize UART for communication
+    uart_rx_dma_start(0);  // Commands arrive by DMA, no interrupt per character
+
+    // An unsorted table would make lookups miss, stop with the red LED on
+    if (!cmd_table_check(&led_cmd_table))
+    {
+        led_red_set();
+        while (1);
+    }
+
+    // Button toggles the green LED from its interrupt, nothing polls it
+    hal_gpio_debounce_init(GPIO_BUTTON_DEBOUNCE_MS, 6);
+    hal_gpio_configure_interrupt(GPIO_BUTTON_PORT, GPIO_BUTTON_PIN, INT_RISING_EDGE);
+    hal_gpio_register_callback(GPIO_BUTTON_PIN, button_pressed, 1);
+    hal_gpio_enable_interrupt(GPIO_BUTTON_PIN, 5);
+
+    hal_gpio_sampler_init(LA_SAMPLE_RATE_HZ, 7);
+
+    while (1)
+    {
+        // A capture owns the UART until it ends, commands wait in the RX ring meanwhile
+        if (la_capturing)
+        {
+            hal_gpio_sampler_process();
+            if (hal_dwt_deadline_expired(&la_capture_end))
+            {
+                hal_gpio_sampler_stop();
+                la_capturing = 0;
+                uart_send_static("OK\n");
+            }
+            continue;
+        }
+
+        // Take a command once a whole line has arrived, sleep until the next interrupt otherwise
+        if (!uart_read_line(command, sizeof(command)))
+        {
+            __WFI();
+            continue;
+        }
+
+        // Split in place, looked up by binary search, no copy of the line
+        switch (cmd_dispatch(&led_cmd_table, command, &reply))
+        {
+        case CMD_UNKNOWN:
+            reply = "UNKNOWN COMMAND\n";  // Send error for unknown commands
+            break;
+        case CMD_BAD_ARGS:
+            reply = "BAD ARGUMENT\n";
+            break;
+        default:
+            break;
+        }
+        if (reply)
+            uart_send_static(reply);
+    }
+}
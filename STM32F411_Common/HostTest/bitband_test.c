@@ -0,0 +1,84 @@
+/*
+ * Host check of the bit-band alias address calculation in hal_gpio_fast.h.
+ *
+ *   ./bitband_test
+ *
+ * Known alias addresses worked out from the reference manual formula are checked first. Then every bit of every
+ * GPIO register is checked against an independent bit-field form of the mapping and mapped back to its register
+ * byte and bit. Exit status is non-zero on any mismatch.
+ */
+
+#include "hal_gpio_fast.h"
+#include <stdio.h>
+
+/* Alias address of a register bit as the driver computes it, no memory is accessed */
+#define ALIAS_OF(reg, bit)      ((uint32_t)(uintptr_t)&HAL_BITBAND_PERIPH(reg, bit))
+
+static int failures;
+
+static void check(const char *what, uint32_t got, uint32_t expected)
+{
+	if (got != expected)
+	{
+		printf("FAIL %-24s 0x%08X, expected 0x%08X\n", what, (unsigned)got, (unsigned)expected);
+		failures++;
+	}
+}
+
+/* Alias = 0x42000000 | (offset from 0x40000000) << 5 | bit << 2, valid for the 1MB peripheral region */
+static uint32_t reference_alias(uint32_t reg_addr, uint32_t bit)
+{
+	return 0x42000000U | ((reg_addr & 0x000FFFFFU) << 5) | (bit << 2);
+}
+
+static void check_known(void)
+{
+	/* PERIPH_BB_BASE + (reg - PERIPH_BASE) * 32 + bit * 4, worked out by hand */
+	check("GPIOA->IDR bit 0",        ALIAS_OF(GPIOA->IDR, 0),                        0x42400200U);
+	check("GPIOD->ODR bit 12",       ALIAS_OF(GPIOD->ODR, 12),                       0x424182B0U);
+	check("GPIOH->ODR bit 15",       ALIAS_OF(GPIOH->ODR, 15),                       0x424382BCU);
+	check("USART2->SR TXE",          ALIAS_OF(USART2->SR, USART_SR_TXE_Pos),         0x4208801CU);
+	check("USART2->SR RXNE",         ALIAS_OF(USART2->SR, USART_SR_RXNE_Pos),        0x42088014U);
+	check("RCC->AHB1ENR GPIODEN",    ALIAS_OF(RCC->AHB1ENR, RCC_AHB1ENR_GPIODEN_Pos), 0x4247060CU);
+	check("GPIOA->MODER bit 31",     ALIAS_OF(GPIOA->MODER, 31),                     0x4240007CU);
+}
+
+static void check_gpio(void)
+{
+	GPIO_TypeDef *const ports[] = { GPIOA, GPIOB, GPIOC, GPIOD, GPIOE, GPIOH };
+	uint32_t checked = 0;
+	
+	for (uint32_t p = 0; p < sizeof(ports) / sizeof(ports[0]); p++)
+	{
+		/* MODER ... AFR[1], one word each */
+		for (uint32_t r = 0; r < sizeof(GPIO_TypeDef) / 4; r++)
+		{
+			uint32_t reg_addr = (uint32_t)(uintptr_t)ports[p] + 4 * r;
+			
+			for (uint32_t bit = 0; bit < 32; bit++)
+			{
+				uint32_t alias = HAL_BITBAND_PERIPH_ADDR(reg_addr, bit);
+				char what[32];
+				
+				snprintf(what, sizeof(what), "port %u reg %u bit %u", (unsigned)p, (unsigned)r, (unsigned)bit);
+				check(what, alias, reference_alias(reg_addr, bit));
+				/* Word aligned, inside the 32MB alias region, and maps back to the same byte and bit of the register:
+				   each alias word stands for one bit of one byte, bit n of a word is bit n%8 of byte n/8 */
+				check(what, alias & 3U, 0);
+				check(what, (alias - PERIPH_BB_BASE) < 0x02000000U, 1);
+				check(what, PERIPH_BASE + ((alias - PERIPH_BB_BASE) >> 5), reg_addr + bit / 8);
+				check(what, (alias >> 2) & 7U, bit % 8);
+				checked++;
+			}
+		}
+	}
+	printf("GPIO register bits checked: %u\n", (unsigned)checked);
+}
+
+int main(void)
+{
+	check_known();
+	check_gpio();
+	printf("%s\n", failures ? "FAIL" : "ok");
+	return failures != 0;
+}
@@ -0,0 +1,94 @@
+#include <stdint.h>
+#include "fixed_fmt.h"
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Copies a string
+  * @param   *buf : destination
+  * @param   *str : NUL terminated source
+  * @retval  char*: end of the output (its NUL)
+  */
+
+char *fmt_str(char *buf, const char *str)
+{
+	while (*str)
+	{
+		*buf++ = *str++;
+	}
+	*buf = '\0';
+	return buf;
+}
+
+/**
+  * @brief   Formats an unsigned decimal
+  * @param   *buf  : destination, at least FMT_U32_MAX_LEN + 1 bytes
+  * @param   value : number to format
+  * @retval  char*: end of the output (its NUL)
+  */
+
+char *fmt_u32(char *buf, uint32_t value)
+{
+	char digits[FMT_U32_MAX_LEN];
+	uint8_t n = 0;
+	
+	/* Least significant digit first, then copy out in reverse */
+	do
+	{
+		digits[n++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value);
+	
+	while (n)
+	{
+		*buf++ = digits[--n];
+	}
+	*buf = '\0';
+	return buf;
+}
+
+/**
+  * @brief   Formats a signed decimal
+  * @param   *buf  : destination, at least FMT_I32_MAX_LEN + 1 bytes
+  * @param   value : number to format
+  * @retval  char*: end of the output (its NUL)
+  */
+
+char *fmt_i32(char *buf, int32_t value)
+{
+	if (value < 0)
+	{
+		*buf++ = '-';
+		/* Negate in unsigned arithmetic so INT32_MIN does not overflow */
+		return fmt_u32(buf, 0U - (uint32_t)value);
+	}
+	return fmt_u32(buf, (uint32_t)value);
+}
+
+/**
+  * @brief   Formats a value held in tenths with one decimal place, e.g. -5 as "-0.5" and 235 as "23.5"
+  * @param   *buf  : destination, at least FMT_X10_MAX_LEN + 1 bytes
+  * @param   value : number of tenths
+  * @retval  char*: end of the output (its NUL)
+  */
+
+char *fmt_x10(char *buf, int32_t value)
+{
+	uint32_t magnitude = (uint32_t)value;
+	
+	if (value < 0)
+	{
+		*buf++ = '-';
+		magnitude = 0U - magnitude;
+	}
+	buf = fmt_u32(buf, magnitude / 10);
+	*buf++ = '.';
+	*buf++ = (char)('0' + magnitude % 10);
+	*buf = '\0';
+	return buf;
+}
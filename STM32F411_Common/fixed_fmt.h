@@ -0,0 +1,72 @@
+#ifndef _FIXED_FMT_H
+#define _FIXED_FMT_H
+
+#include <stdint.h>
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Allocation-free number formatting                                                                                                     */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/*
+ *  Integer and fixed-point to ASCII conversion into a caller supplied buffer, without printf, floating point or heap.
+ *  Every function writes a NUL terminated string at buf and returns a pointer to that NUL, so calls chain:
+ *
+ *      p = fmt_str(line, "Temp ");
+ *      p = fmt_x10(p, -123);             line = "Temp -12.3"
+ *      HAL_UART_Transmit(&huart2, (uint8_t *)line, p - line, 100);
+ *
+ *  No length is checked: the caller provides room for the longest output plus the NUL.
+ */
+
+#define FMT_U32_MAX_LEN      10          /* "4294967295" */
+#define FMT_I32_MAX_LEN      11          /* "-2147483648" */
+#define FMT_X10_MAX_LEN      12          /* "-214748364.8" */
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Copies a string
+  * @param   *buf : destination
+  * @param   *str : NUL terminated source
+  * @retval  char*: end of the output (its NUL)
+  */
+
+char *fmt_str(char *buf, const char *str);
+
+/**
+  * @brief   Formats an unsigned decimal
+  * @param   *buf  : destination, at least FMT_U32_MAX_LEN + 1 bytes
+  * @param   value : number to format
+  * @retval  char*: end of the output (its NUL)
+  */
+
+char *fmt_u32(char *buf, uint32_t value);
+
+/**
+  * @brief   Formats a signed decimal
+  * @param   *buf  : destination, at least FMT_I32_MAX_LEN + 1 bytes
+  * @param   value : number to format
+  * @retval  char*: end of the output (its NUL)
+  */
+
+char *fmt_i32(char *buf, int32_t value);
+
+/**
+  * @brief   Formats a value held in tenths with one decimal place, e.g. -5 as "-0.5" and 235 as "23.5"
+  * @param   *buf  : destination, at least FMT_X10_MAX_LEN + 1 bytes
+  * @param   value : number of tenths
+  * @retval  char*: end of the output (its NUL)
+  */
+
+char *fmt_x10(char *buf, int32_t value);
+
+
+#endif
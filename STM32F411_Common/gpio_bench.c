@@ -0,0 +1,285 @@
+#include <stdint.h>
+#include "gpio_bench.h"
+#include "hal_gpio_driver.h"
+#include "fixed_fmt.h"
+
+
+/* Results are stored here so the compiler keeps every read */
+static volatile uint32_t gpio_bench_sink;
+
+/* Compile-time descriptor of the output pin, for the GPIO_PIN_DEFINE() cases */
+GPIO_PIN_DEFINE(bench_pin, GPIO_BENCH_PORT_BASE, GPIO_BENCH_OUT_PIN)
+
+static gpio_pin_conf_t bench_pin_conf =
+{
+	GPIO_BENCH_OUT_PIN, GPIO_PIN_OUTPUT_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED, 0
+};
+
+/* The four LEDs of the board, as configured by board_init() */
+static const gpio_board_pin_t bench_board_pins[] =
+{
+	{ GPIO_BENCH_PORT, { 12, GPIO_PIN_OUTPUT_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED, 0 } },
+	{ GPIO_BENCH_PORT, { 13, GPIO_PIN_OUTPUT_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED, 0 } },
+	{ GPIO_BENCH_PORT, { 14, GPIO_PIN_OUTPUT_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED, 0 } },
+	{ GPIO_BENCH_PORT, { 15, GPIO_PIN_OUTPUT_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED, 0 } },
+};
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Benchmark cases                                                                                                                       */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+static void bench_nop(void)
+{
+}
+
+static void bench_write_to_pin(void)
+{
+	hal_gpio_write_to_pin(GPIO_BENCH_PORT, GPIO_BENCH_OUT_PIN, 1);
+}
+
+static void bench_read_from_pin(void)
+{
+	gpio_bench_sink = hal_gpio_read_from_pin(GPIO_BENCH_PORT, GPIO_BENCH_IN_PIN);
+}
+
+static void bench_init(void)
+{
+	hal_gpio_init(GPIO_BENCH_PORT, &bench_pin_conf);
+}
+
+static void bench_init_board(void)
+{
+	hal_gpio_init_board(bench_board_pins, sizeof(bench_board_pins) / sizeof(bench_board_pins[0]));
+}
+
+static void bench_set_pins(void)
+{
+	hal_gpio_set_pins(GPIO_BENCH_PORT, 1U << GPIO_BENCH_OUT_PIN);
+}
+
+static void bench_write_pins(void)
+{
+	hal_gpio_write_pins(GPIO_BENCH_PORT, 0xF000U, 0x5000U);
+}
+
+static void bench_toggle_pins(void)
+{
+	hal_gpio_toggle_pins(GPIO_BENCH_PORT, 1U << GPIO_BENCH_OUT_PIN);
+}
+
+static void bench_toggle_pin(void)
+{
+	hal_gpio_toggle_pin(GPIO_BENCH_PORT, GPIO_BENCH_OUT_PIN);
+}
+
+static void bench_read_pins(void)
+{
+	gpio_bench_sink = hal_gpio_read_pins(GPIO_BENCH_PORT, 1U << GPIO_BENCH_IN_PIN);
+}
+
+static void bench_pin_define_set(void)
+{
+	bench_pin_set();
+}
+
+static void bench_pin_define_toggle(void)
+{
+	bench_pin_toggle();
+}
+
+static void bench_bitband_write(void)
+{
+	HAL_BITBAND_PERIPH(GPIO_BENCH_PORT->ODR, GPIO_BENCH_OUT_PIN) = 1;
+}
+
+static void bench_bitband_read(void)
+{
+	gpio_bench_sink = HAL_BITBAND_PERIPH(GPIO_BENCH_PORT->IDR, GPIO_BENCH_IN_PIN);
+}
+
+const gpio_bench_case_t gpio_bench_driver_cases[] =
+{
+	{ "hal_gpio_write_to_pin",          bench_write_to_pin },
+	{ "hal_gpio_read_from_pin",         bench_read_from_pin },
+	{ "hal_gpio_init (1 pin)",          bench_init },
+	{ "hal_gpio_init_board (4 pins)",   bench_init_board },
+};
+const uint32_t gpio_bench_driver_case_count = sizeof(gpio_bench_driver_cases) / sizeof(gpio_bench_driver_cases[0]);
+
+const gpio_bench_case_t gpio_bench_fast_cases[] =
+{
+	{ "hal_gpio_set_pins",              bench_set_pins },
+	{ "hal_gpio_write_pins (4 pins)",   bench_write_pins },
+	{ "hal_gpio_toggle_pins",           bench_toggle_pins },
+	{ "hal_gpio_toggle_pin",            bench_toggle_pin },
+	{ "hal_gpio_read_pins",             bench_read_pins },
+	{ "GPIO_PIN_DEFINE set",            bench_pin_define_set },
+	{ "GPIO_PIN_DEFINE toggle",         bench_pin_define_toggle },
+	{ "HAL_BITBAND_PERIPH write",       bench_bitband_write },
+	{ "HAL_BITBAND_PERIPH read",        bench_bitband_read },
+};
+const uint32_t gpio_bench_fast_case_count = sizeof(gpio_bench_fast_cases) / sizeof(gpio_bench_fast_cases[0]);
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Static helper functions                                                                                                               */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Calls an operation `runs` times and keeps the smallest and the average count
+  * @param   *bench : benchmark run
+  * @param   op     : operation
+  * @param   *min   : smallest count of one call
+  * @param   *avg   : average count of one call
+  * @retval  None
+  */
+
+static void gpio_bench_measure(const gpio_bench_t *bench, void (*op)(void), uint32_t *min, uint32_t *avg)
+{
+	uint32_t runs = bench->runs ? bench->runs : GPIO_BENCH_RUNS;
+	uint32_t best = 0xFFFFFFFFU;
+	uint32_t sum = 0;
+	uint32_t start, count, i;
+
+	for (i = 0; i < runs; i++)
+	{
+		start = bench->counter();
+		op();
+		count = bench->counter() - start;
+
+		sum += count;
+		if (count < best)
+		{
+			best = count;
+		}
+	}
+
+	*min = best;
+	*avg = sum / runs;
+}
+
+/**
+  * @brief   Appends spaces up to a column
+  * @param   *p     : end of the line so far
+  * @param   *line  : start of the line
+  * @param   column : width to reach
+  * @retval  char*: end of the line
+  */
+
+static char *gpio_bench_pad(char *p, const char *line, uint32_t column)
+{
+	while ((uint32_t)(p - line) < column)
+	{
+		*p++ = ' ';
+	}
+	*p = '\0';
+	return p;
+}
+
+/**
+  * @brief   Appends a count right aligned in a value column, call overhead removed
+  * @param   *p     : end of the line so far
+  * @param   *line  : start of the line
+  * @param   column : right edge of the value
+  * @param   value  : count including the overhead
+  * @param   base   : overhead
+  * @retval  char*: end of the line
+  */
+
+static char *gpio_bench_value(char *p, const char *line, uint32_t column, uint32_t value, uint32_t base)
+{
+	char digits[FMT_U32_MAX_LEN + 1];
+	uint32_t len = (uint32_t)(fmt_u32(digits, value > base ? value - base : 0) - digits);
+
+	p = gpio_bench_pad(p, line, column - len);
+	return fmt_str(p, digits);
+}
+
+/**
+  * @brief   Writes a NUL terminated string
+  * @param   *bench : benchmark run
+  * @param   *str   : text
+  * @param   *end   : its NUL
+  * @retval  None
+  */
+
+static void gpio_bench_write(const gpio_bench_t *bench, const char *str, const char *end)
+{
+	bench->write((const uint8_t *)str, (uint32_t)(end - str));
+}
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Measures the call overhead and writes the table header
+  * @param   *bench : benchmark run, counter, unit and write must be set
+  * @retval  None
+  */
+
+void gpio_bench_begin(gpio_bench_t *bench)
+{
+	char line[96];
+	char *p;
+	uint32_t avg;
+
+	gpio_bench_measure(bench, bench_nop, &bench->baseline, &avg);
+
+	p = fmt_str(line, "GPIO benchmark, ");
+	p = fmt_str(p, bench->unit);
+	p = fmt_str(p, " per call, ");
+	p = fmt_u32(p, bench->runs ? bench->runs : GPIO_BENCH_RUNS);
+	p = fmt_str(p, " runs, call overhead ");
+	p = fmt_u32(p, bench->baseline);
+	p = fmt_str(p, " removed\r\n");
+	gpio_bench_write(bench, line, p);
+
+	p = fmt_str(line, "operation");
+	p = gpio_bench_pad(p, line, GPIO_BENCH_NAME_WIDTH + GPIO_BENCH_VALUE_WIDTH - 3);
+	p = fmt_str(p, "min");
+	p = gpio_bench_pad(p, line, GPIO_BENCH_NAME_WIDTH + 2 * GPIO_BENCH_VALUE_WIDTH - 3);
+	p = fmt_str(p, "avg\r\n");
+	gpio_bench_write(bench, line, p);
+}
+
+/**
+  * @brief   Measures a list of cases and writes one row per case under a section title
+  * @param   *bench : benchmark run started with gpio_bench_begin()
+  * @param   *title : section title
+  * @param   *cases : cases to measure
+  * @param   count  : number of cases
+  * @retval  None
+  */
+
+void gpio_bench_section(gpio_bench_t *bench, const char *title, const gpio_bench_case_t *cases, uint32_t count)
+{
+	char line[96];
+	char *p;
+	uint32_t min, avg, i;
+
+	p = fmt_str(line, "-- ");
+	p = fmt_str(p, title);
+	p = fmt_str(p, "\r\n");
+	gpio_bench_write(bench, line, p);
+
+	for (i = 0; i < count; i++)
+	{
+		gpio_bench_measure(bench, cases[i].op, &min, &avg);
+
+		p = fmt_str(line, cases[i].name);
+		p = gpio_bench_pad(p, line, GPIO_BENCH_NAME_WIDTH);
+		p = gpio_bench_value(p, line, GPIO_BENCH_NAME_WIDTH + GPIO_BENCH_VALUE_WIDTH, min, bench->baseline);
+		p = gpio_bench_value(p, line, GPIO_BENCH_NAME_WIDTH + 2 * GPIO_BENCH_VALUE_WIDTH, avg, bench->baseline);
+		p = fmt_str(p, "\r\n");
+		gpio_bench_write(bench, line, p);
+	}
+}
@@ -0,0 +1,107 @@
+#ifndef _GPIO_BENCH_H
+#define _GPIO_BENCH_H
+
+#include <stdint.h>
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     GPIO micro-benchmark                                                                                                                  */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/*
+ *  Every case is one GPIO operation wrapped in a function. The counter is read before and after each call, over `runs`
+ *  calls, and the cost of an empty case (call and counter overhead) is subtracted from the minimum and the average.
+ *  The minimum is the figure to compare: it rejects the occasional interrupt or bus stall.
+ *
+ *  On target the counter is the DWT cycle counter. The host mock-register build uses its own counter and unit, so the
+ *  same table gives instruction counts in CI.
+ *
+ *      gpio_bench_begin(&bench);                                         header and call overhead
+ *      gpio_bench_section(&bench, "Custom driver", gpio_bench_driver_cases, gpio_bench_driver_case_count);
+ */
+
+#define GPIO_BENCH_RUNS                  64U
+
+/* Pins the cases drive and read, PD12 is the green LED and PD0 the button of the board */
+#define GPIO_BENCH_PORT                  GPIOD
+#define GPIO_BENCH_PORT_BASE             GPIOD_BASE
+#define GPIO_BENCH_OUT_PIN               12U
+#define GPIO_BENCH_IN_PIN                0U
+
+/* Column widths of the table */
+#define GPIO_BENCH_NAME_WIDTH            34U
+#define GPIO_BENCH_VALUE_WIDTH           8U
+
+/* Free running counter read around each call, unsigned wrap-around is handled */
+typedef uint32_t (*gpio_bench_counter_t)(void);
+
+/* Output of the table, e.g. uart_send_bytes */
+typedef void (*gpio_bench_write_t)(const uint8_t *data, uint32_t len);
+
+/**
+* @brief   Benchmark case
+*
+*/
+
+typedef struct
+{
+  const char *name;                      /*Row label */
+  void (*op)(void);                      /*Performs the operation once */
+}gpio_bench_case_t;
+
+/**
+* @brief   Benchmark run
+*          Filled by the application, baseline is measured by gpio_bench_begin()
+*
+*/
+
+typedef struct
+{
+  gpio_bench_counter_t counter;          /*Counter read around each call */
+  const char *unit;                      /*What the counter counts, e.g. "cycles" */
+  gpio_bench_write_t write;              /*Output of the table */
+  uint32_t runs;                         /*Calls per case, 0 selects GPIO_BENCH_RUNS */
+  uint32_t baseline;                     /*Minimum count of an empty case */
+}gpio_bench_t;
+
+
+/* Cases of the bare-metal driver and its inline fast paths (gpio_bench.c) */
+extern const gpio_bench_case_t gpio_bench_driver_cases[];
+extern const uint32_t gpio_bench_driver_case_count;
+extern const gpio_bench_case_t gpio_bench_fast_cases[];
+extern const uint32_t gpio_bench_fast_case_count;
+
+/* Cases of the ST HAL (gpio_bench_hal.c, links stm32f4xx_hal_gpio.c) */
+extern const gpio_bench_case_t gpio_bench_hal_cases[];
+extern const uint32_t gpio_bench_hal_case_count;
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Measures the call overhead and writes the table header
+  * @param   *bench : benchmark run, counter, unit and write must be set
+  * @retval  None
+  */
+
+void gpio_bench_begin(gpio_bench_t *bench);
+
+/**
+  * @brief   Measures a list of cases and writes one row per case under a section title
+  * @param   *bench : benchmark run started with gpio_bench_begin()
+  * @param   *title : section title
+  * @param   *cases : cases to measure
+  * @param   count  : number of cases
+  * @retval  None
+  */
+
+void gpio_bench_section(gpio_bench_t *bench, const char *title, const gpio_bench_case_t *cases, uint32_t count);
+
+
+#endif
@@ -0,0 +1,53 @@
+#include <stdint.h>
+#include "stm32f4xx_hal.h"
+#include "gpio_bench.h"
+
+
+/*
+ *  ST HAL cases, in a file of their own: the HAL and the bare-metal driver headers are never included together.
+ *  Only stm32f4xx_hal_gpio.c is needed at link time.
+ */
+
+/* Results are stored here so the compiler keeps every read */
+static volatile uint32_t gpio_bench_hal_sink;
+
+static GPIO_InitTypeDef bench_hal_init_conf =
+{
+	1U << GPIO_BENCH_OUT_PIN, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_MEDIUM, 0
+};
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Benchmark cases                                                                                                                       */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+static void bench_hal_write_pin(void)
+{
+	HAL_GPIO_WritePin(GPIO_BENCH_PORT, 1U << GPIO_BENCH_OUT_PIN, GPIO_PIN_SET);
+}
+
+static void bench_hal_read_pin(void)
+{
+	gpio_bench_hal_sink = HAL_GPIO_ReadPin(GPIO_BENCH_PORT, 1U << GPIO_BENCH_IN_PIN);
+}
+
+static void bench_hal_toggle_pin(void)
+{
+	HAL_GPIO_TogglePin(GPIO_BENCH_PORT, 1U << GPIO_BENCH_OUT_PIN);
+}
+
+static void bench_hal_init(void)
+{
+	HAL_GPIO_Init(GPIO_BENCH_PORT, &bench_hal_init_conf);
+}
+
+const gpio_bench_case_t gpio_bench_hal_cases[] =
+{
+	{ "HAL_GPIO_WritePin",              bench_hal_write_pin },
+	{ "HAL_GPIO_ReadPin",               bench_hal_read_pin },
+	{ "HAL_GPIO_TogglePin",             bench_hal_toggle_pin },
+	{ "HAL_GPIO_Init (1 pin)",          bench_hal_init },
+};
+const uint32_t gpio_bench_hal_case_count = sizeof(gpio_bench_hal_cases) / sizeof(gpio_bench_hal_cases[0]);
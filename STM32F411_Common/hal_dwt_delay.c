@@ -0,0 +1,87 @@
+#include <stdint.h>
+#include "hal_dwt_delay.h"
+
+
+uint32_t hal_dwt_cycles_per_us = 16;     /* HSI reset clock until hal_dwt_init() runs */
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Enables the DWT cycle counter and caches the cycles per microsecond for the current SystemCoreClock
+  * @param   None
+  * @retval  None
+  */
+
+void hal_dwt_init(void)
+{
+	/* Trace must be enabled for the DWT unit to run */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	
+	if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+	{
+		DWT->CYCCNT = 0;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+	
+	hal_dwt_cycles_per_us = SystemCoreClock / 1000000;
+}
+
+/**
+  * @brief   Busy waits for the given number of microseconds
+  * @param   us : delay in microseconds
+  * @retval  None
+  */
+
+void hal_dwt_delay_us(uint32_t us)
+{
+	uint32_t start = DWT->CYCCNT;
+	uint32_t cycles = us * hal_dwt_cycles_per_us;
+	
+	while ((uint32_t)(DWT->CYCCNT - start) < cycles);
+}
+
+/**
+  * @brief   Busy waits for the given number of milliseconds
+  * @param   ms : delay in milliseconds
+  * @retval  None
+  */
+
+void hal_dwt_delay_ms(uint32_t ms)
+{
+	/* 1ms at a time so the cycle budget never overflows the 32 bit counter */
+	while (ms--)
+	{
+		hal_dwt_delay_us(1000);
+	}
+}
+
+/**
+  * @brief   Waits until (*reg & mask) == expected or the timeout expires
+  * @param   *reg       : register to poll
+  * @param   mask       : bits to test
+  * @param   expected   : value of the masked bits to wait for
+  * @param   timeout_us : timeout in microseconds
+  * @retval  uint8_t: 1 if the condition was met, 0 on timeout
+  */
+
+uint8_t hal_dwt_wait_flag(volatile uint32_t *reg, uint32_t mask, uint32_t expected, uint32_t timeout_us)
+{
+	hal_dwt_deadline_t deadline;
+	
+	hal_dwt_deadline_set(&deadline, timeout_us);
+	
+	while ((*reg & mask) != expected)
+	{
+		if (hal_dwt_deadline_expired(&deadline))
+		{
+			return 0;
+		}
+	}
+	
+	return 1;
+}
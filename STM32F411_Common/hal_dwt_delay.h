@@ -0,0 +1,135 @@
+#ifndef _HAL_DWT_DELAY_H
+#define _HAL_DWT_DELAY_H
+
+#include <stdint.h>
+#include "stm32f411xe.h"
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Cycle counter timebase                                                                                                                */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/*
+ *  Delays and timeouts are measured on the Cortex-M4 DWT cycle counter (CYCCNT), which counts core clock cycles
+ *  independently of the compiler optimization level, flash wait states or interrupts.
+ *  hal_dwt_init() must be called again whenever SystemCoreClock changes.
+ */
+
+/* Core clock cycles per microsecond, cached by hal_dwt_init() */
+extern uint32_t hal_dwt_cycles_per_us;
+
+/**
+* @brief   Deadline structure
+*          Filled by hal_dwt_deadline_set() and checked with hal_dwt_deadline_expired()
+*
+*/
+
+typedef struct
+{
+  uint32_t start;                        /*Cycle counter value when the deadline was set */
+  uint32_t cycles;                       /*Budget in core clock cycles */
+}hal_dwt_deadline_t;
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Enables the DWT cycle counter and caches the cycles per microsecond for the current SystemCoreClock
+  * @param   None
+  * @retval  None
+  */
+
+void hal_dwt_init(void);
+
+/**
+  * @brief   Busy waits for the given number of microseconds
+  * @param   us : delay in microseconds
+  * @retval  None
+  */
+
+void hal_dwt_delay_us(uint32_t us);
+
+/**
+  * @brief   Busy waits for the given number of milliseconds
+  * @param   ms : delay in milliseconds
+  * @retval  None
+  */
+
+void hal_dwt_delay_ms(uint32_t ms);
+
+/**
+  * @brief   Waits until (*reg & mask) == expected or the timeout expires
+  * @param   *reg       : register to poll
+  * @param   mask       : bits to test
+  * @param   expected   : value of the masked bits to wait for
+  * @param   timeout_us : timeout in microseconds
+  * @retval  uint8_t: 1 if the condition was met, 0 on timeout
+  */
+
+uint8_t hal_dwt_wait_flag(volatile uint32_t *reg, uint32_t mask, uint32_t expected, uint32_t timeout_us);
+
+/**
+  * @brief   Reads the current cycle count
+  * @param   None
+  * @retval  uint32_t: DWT cycle counter
+  */
+
+static inline uint32_t hal_dwt_get_cycles(void)
+{
+	return DWT->CYCCNT;
+}
+
+/**
+  * @brief   Converts microseconds to core clock cycles
+  * @param   us : time in microseconds
+  * @retval  uint32_t: cycles
+  */
+
+static inline uint32_t hal_dwt_us_to_cycles(uint32_t us)
+{
+	return us * hal_dwt_cycles_per_us;
+}
+
+/**
+  * @brief   Starts a deadline that expires after the given number of microseconds
+  * @param   *deadline : deadline to set
+  * @param   us        : budget in microseconds
+  * @retval  None
+  */
+
+static inline void hal_dwt_deadline_set(hal_dwt_deadline_t *deadline, uint32_t us)
+{
+	deadline->start = DWT->CYCCNT;
+	deadline->cycles = us * hal_dwt_cycles_per_us;
+}
+
+/**
+  * @brief   Checks whether a deadline has passed, unsigned subtraction handles counter wrap-around
+  * @param   *deadline : deadline to check
+  * @retval  uint8_t: 1 if expired
+  */
+
+static inline uint8_t hal_dwt_deadline_expired(const hal_dwt_deadline_t *deadline)
+{
+	return (uint32_t)(DWT->CYCCNT - deadline->start) >= deadline->cycles;
+}
+
+/**
+  * @brief   Cycles elapsed since a deadline was set
+  * @param   *deadline : deadline to check
+  * @retval  uint32_t: elapsed cycles
+  */
+
+static inline uint32_t hal_dwt_deadline_elapsed(const hal_dwt_deadline_t *deadline)
+{
+	return DWT->CYCCNT - deadline->start;
+}
+
+
+#endif
@@ -0,0 +1,646 @@
+#include <stdint.h>
+#include "hal_gpio_driver.h"
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Static helper functions                                                                                                               */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Configures the mode of a pin : input, output, alternate function or analog mode
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   pin_no : GPIO pin number
+  * @param   mode   : mode to be configured
+	* @retval  None
+  */
+
+static void hal_gpio_configure_pin_mode(GPIO_TypeDef *GPIOx, uint16_t pin_no, uint32_t mode)
+{
+	  GPIOx->MODER  |= (mode << ( 2 * pin_no));
+	
+}
+
+/**
+  * @brief   Configures the output type a pin : push-pull or open drain
+  * @param   *GPIOx  : GPIO Port Base address
+  * @param   pin_no  : GPIO pin number
+  * @param   op_type : mode to be configured
+	* @retval  None
+  */
+
+static void hal_gpio_configure_pin_otype(GPIO_TypeDef *GPIOx, uint16_t pin_no, uint32_t op_type)
+{
+		
+	  /* OTYPER has one bit per pin, written through its bit-band alias */
+	  HAL_BITBAND_PERIPH(GPIOx->OTYPER, pin_no) = op_type;
+	
+	
+}
+
+
+/**
+  * @brief   Activates the internal pull up or pull down registers 
+  * @param   *GPIOx  : GPIO Port Base address
+  * @param   pin_no  : GPIO pin number
+  * @param   pupd` : specifies which registers to activate
+	* @retval  None
+  */
+
+static void hal_gpio_configure_pin_pupd(GPIO_TypeDef *GPIOx, uint16_t pin_no, uint32_t pupd)
+{
+	
+	  GPIOx->PUPDR  |= (pupd << ( 2 * pin_no));
+	
+	
+	
+	
+}
+
+
+/**
+  * @brief   Configures the output type a pin : push-pull or open drain
+  * @param   *GPIOx  : GPIO Port Base address
+  * @param   pin_no  : GPIO pin number
+  * @param   speed` : mode to be configured
+	* @retval  None
+  */
+
+static void hal_gpio_configure_pin_speed(GPIO_TypeDef *GPIOx, uint16_t pin_no, uint32_t speed)
+{
+	
+	  GPIOx->OSPEEDR  |= (speed << ( 2 * pin_no));
+	
+	
+}
+
+
+
+
+/* GPIO ports are 0x400 apart from GPIOA, GPIOH is index 7 */
+#define GPIO_PORT_INDEX(GPIOx)     (((uint32_t)(GPIOx) - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE))
+#define GPIO_PORT_COUNT            8
+
+/**
+* @brief   Register image of one port, built by hal_gpio_init_board()
+*          mask selects the fields of the configured pins, value holds their new content
+*
+*/
+
+typedef struct
+{
+	uint32_t moder_mask, moder;
+	uint32_t otyper_mask, otyper;
+	uint32_t ospeedr_mask, ospeedr;
+	uint32_t pupdr_mask, pupdr;
+	uint32_t afr_mask[2], afr[2];
+}gpio_port_image_t;
+
+/**
+  * @brief   Applies the masked fields of a port image, one write per register
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   *image : register image of the port
+	* @retval  None
+  */
+
+static void hal_gpio_apply_port_image(GPIO_TypeDef *GPIOx, const gpio_port_image_t *image)
+{
+	GPIOx->MODER   = (GPIOx->MODER   & ~image->moder_mask)   | image->moder;
+	GPIOx->OTYPER  = (GPIOx->OTYPER  & ~image->otyper_mask)  | image->otyper;
+	GPIOx->OSPEEDR = (GPIOx->OSPEEDR & ~image->ospeedr_mask) | image->ospeedr;
+	GPIOx->PUPDR   = (GPIOx->PUPDR   & ~image->pupdr_mask)   | image->pupdr;
+	GPIOx->AFR[0]  = (GPIOx->AFR[0]  & ~image->afr_mask[0])  | image->afr[0];
+	GPIOx->AFR[1]  = (GPIOx->AFR[1]  & ~image->afr_mask[1])  | image->afr[1];
+}
+
+
+
+/* EXTI callback registry and debounce state, bit n is line n */
+static hal_gpio_exti_callback_t exti_callbacks[16];
+static GPIO_TypeDef *exti_ports[16];
+static uint16_t exti_debounce_lines;
+static volatile uint16_t exti_settling_lines;
+static uint16_t exti_stable_levels;
+static uint16_t exti_rising_lines;                     /* Edges selected by hal_gpio_configure_interrupt() */
+static uint16_t exti_falling_lines;
+
+static volatile gpio_tim1_owner_t tim1_owner;          /* Wave generator or logic sampler running on TIM1 */
+
+/*
+ *  EXTI->IMR and exti_settling_lines are changed by the EXTI handlers, the debounce timer handler and the main loop,
+ *  which run at different priorities. Every read-modify-write of them goes through these two, with PRIMASK set for the
+ *  few instructions it takes, so no update is lost to a preempting handler. The settle also restarts the debounce
+ *  timer in the same section, the timer handler cannot stop it between the restart and the new line.
+ */
+static void hal_gpio_exti_settle(uint32_t line_mask)
+{
+	uint32_t primask = __get_PRIMASK();
+	
+	__disable_irq();
+	EXTI->IMR &= ~line_mask;
+	exti_settling_lines |= line_mask;
+	/* (Re)start the one-shot delay, an update from the old count is dropped so it cannot end the new delay early */
+	GPIO_DEBOUNCE_TIMER->CR1 &= ~TIM_CR1_CEN;
+	GPIO_DEBOUNCE_TIMER->CNT = 0;
+	GPIO_DEBOUNCE_TIMER->SR = ~(uint32_t)TIM_SR_UIF;
+	GPIO_DEBOUNCE_TIMER->CR1 |= TIM_CR1_CEN;
+	__set_PRIMASK(primask);
+}
+
+static void hal_gpio_exti_unmask(uint32_t line_mask)
+{
+	uint32_t primask = __get_PRIMASK();
+	
+	__disable_irq();
+	EXTI->IMR |= line_mask;
+	__set_PRIMASK(primask);
+}
+
+/*
+ *  A debounced line triggers on both edges whatever edge was selected: the settled level has to follow the release as
+ *  well as the press, the selected edges only filter the callbacks. The other lines trigger on the selected edges.
+ */
+static void hal_gpio_exti_apply_edges(uint16_t pin_no)
+{
+	uint32_t line_mask = (1U << pin_no);
+	uint32_t rising = exti_rising_lines;
+	uint32_t falling = exti_falling_lines;
+	
+	if ((exti_debounce_lines & line_mask) && ((rising | falling) & line_mask))
+	{
+		rising |= line_mask;
+		falling |= line_mask;
+	}
+	EXTI->RTSR = (EXTI->RTSR & ~line_mask) | (rising & line_mask);
+	EXTI->FTSR = (EXTI->FTSR & ~line_mask) | (falling & line_mask);
+}
+
+/**
+  * @brief   Serves the pending EXTI lines of one interrupt vector
+  * @param   lines : EXTI lines served by the vector
+	* @retval  None
+  */
+
+static void hal_gpio_exti_dispatch(uint32_t lines)
+{
+	uint32_t pending = EXTI->PR & EXTI->IMR & lines;
+	uint32_t line;
+	
+	/* Write 1 to clear */
+	EXTI->PR = pending;
+	
+	for (line = 0; pending; line++, pending >>= 1)
+	{
+		if (!(pending & 1U))
+		{
+			continue;
+		}
+		if (exti_debounce_lines & (1U << line))
+		{
+			/* Ignore the bounces, look again once the timer expires (restarted by every new line) */
+			hal_gpio_exti_settle(1U << line);
+		}
+		else if (exti_callbacks[line] && exti_ports[line])
+		{
+			exti_callbacks[line](line, hal_gpio_read_from_pin(exti_ports[line], line));
+		}
+	}
+}
+
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Initializes the gpio pin
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   *gpio_pin_conf : Pointer to the pin conf structure sent by application
+  * @retval  None
+  */
+
+void hal_gpio_init(GPIO_TypeDef *GPIOx, gpio_pin_conf_t *gpio_pin_conf)
+{
+	
+	hal_gpio_configure_pin_mode(GPIOx,gpio_pin_conf->pin, gpio_pin_conf->mode);
+	hal_gpio_configure_pin_speed(GPIOx,gpio_pin_conf->pin, gpio_pin_conf->speed);
+	hal_gpio_configure_pin_otype(GPIOx,gpio_pin_conf->pin, gpio_pin_conf->op_type);
+	hal_gpio_configure_pin_pupd(GPIOx,gpio_pin_conf->pin, gpio_pin_conf->pull);
+	
+	
+}
+
+/**
+  * @brief   Read a value from a given pin number
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   pin_no : GPIO pin number
+  * @retval  uint8_t: Value read
+  */
+
+uint8_t hal_gpio_read_from_pin(GPIO_TypeDef *GPIOx, uint16_t pin_no)
+{
+	
+	/*   The bit-band alias of the IDR bit reads as 0 or 1, no shift or mask needed  */
+	
+	return (uint8_t)HAL_BITBAND_PERIPH(GPIOx->IDR, pin_no);
+	
+}
+
+/**
+  * @brief   Write a value to a given pin number
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   pin_no : GPIO pin number
+  * @param   uint8_t: Value to be written
+  * @retval  None
+	*/
+
+void hal_gpio_write_to_pin(GPIO_TypeDef *GPIOx, uint16_t pin_no, uint8_t val)
+{
+	
+	/*   The bit-band alias of the ODR bit is written in one locked bus read-modify-write, so an interrupt
+	     updating other pins of the same port cannot be undone here, and no branch is needed on val  */
+	
+	HAL_BITBAND_PERIPH(GPIOx->ODR, pin_no) = (val != 0);
+	
+}
+
+
+/**
+  * @brief   Set the alternate functionality for the given pin number
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   pin_no : GPIO pin number
+  * @param   alt_fun_value: Alternate function to be configured with
+  * @retval  None
+	*/
+void hal_gpio_set_alt_function (GPIO_TypeDef *GPIOx, uint16_t pin_no, uint16_t alt_fun_value)
+{
+	
+	 if (pin_no <= 7)
+	 {
+		 
+		 GPIOx->AFR[0] |= (alt_fun_value<< (( pin_no ) * 4)); 
+	 }
+	
+	 /*    pin_no % 8 calculates the position within AFR[1] by finding the remainder when the pin number is divided by 8. 
+	  *    This ensures that the pin number is offset correctly within the second register (AFR[1]).
+	  *    Example: Pin 8 should correspond to the first 4 bits of AFR[1], so pin_no % 8 = 0.
+    *    Pin 9 should correspond to the second 4 bits of AFR[1], so pin_no % 8 = 1.
+	  *    pin_no % 8: This ensures that the calculation wraps around to bit positions within AFR[1], starting from 0 for pin 8, up to 7 for pin 15.
+    *    * 4: Since each pin requires 4 bits to represent its alternate function, multiplying by 4 ensures the correct bit-shift to place the alternate function value in the correct position.
+	  */
+	else 
+	{
+		GPIOx->AFR[1] |= (alt_fun_value<< (( pin_no % 8) * 4));
+		
+	}
+	
+}
+
+/**
+  * @brief   Configures a whole table of pins and enables the clocks of their ports
+  *          The table is folded into one value per register per port, then MODER, OTYPER, OSPEEDR, PUPDR
+  *          and AFR of each port get a single masked write, whatever the number of pins
+  * @param   *table : board pin table
+  * @param   count  : number of entries
+  * @retval  None
+  */
+
+void hal_gpio_init_board(const gpio_board_pin_t *table, uint32_t count)
+{
+	gpio_port_image_t image[GPIO_PORT_COUNT] = {0};
+	GPIO_TypeDef *ports[GPIO_PORT_COUNT] = {0};
+	uint32_t clocks = 0;
+	uint32_t i;
+	
+	/* Fold every pin into the image of its port */
+	for (i = 0; i < count; i++)
+	{
+		const gpio_pin_conf_t *conf = &table[i].conf;
+		uint32_t idx = GPIO_PORT_INDEX(table[i].port);
+		uint32_t pin = conf->pin;
+		gpio_port_image_t *p = &image[idx];
+		
+		ports[idx] = table[i].port;
+		clocks |= (1U << idx);
+		
+		p->moder_mask   |= (0x3U << (2 * pin));
+		p->moder        |= (conf->mode << (2 * pin));
+		p->otyper_mask  |= (0x1U << pin);
+		p->otyper       |= (conf->op_type << pin);
+		p->ospeedr_mask |= (0x3U << (2 * pin));
+		p->ospeedr      |= (conf->speed << (2 * pin));
+		p->pupdr_mask   |= (0x3U << (2 * pin));
+		p->pupdr        |= (conf->pull << (2 * pin));
+		p->afr_mask[pin / 8] |= (0xFU << ((pin % 8) * 4));
+		p->afr[pin / 8]      |= (conf->alternate << ((pin % 8) * 4));
+	}
+	
+	/* AHB1ENR bit n clocks port n, all ports in one write */
+	RCC->AHB1ENR |= clocks;
+	
+	for (i = 0; i < GPIO_PORT_COUNT; i++)
+	{
+		if (ports[i])
+		{
+			hal_gpio_apply_port_image(ports[i], &image[i]);
+		}
+	}
+}
+
+/**
+  * @brief   Configures the edge and the port of the EXTI line of a pin, enables the SYSCFG clock
+  * @param   *GPIOx   : GPIO Port Base address
+  * @param   pin_no   : GPIO pin number, also the EXTI line number
+  * @param   edge_sel : triggering edge selection value of type "int_edge_sel_t"
+  * @retval  None
+  */
+
+void hal_gpio_configure_interrupt(GPIO_TypeDef *GPIOx, uint16_t pin_no, int_edge_sel_t edge_sel)
+{
+	RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
+	
+	/* EXTICR[n/4] holds a 4 bit port index per line: 0 = GPIOA ... 7 = GPIOH */
+	SYSCFG->EXTICR[pin_no / 4] = (SYSCFG->EXTICR[pin_no / 4] & ~(0xFU << ((pin_no % 4) * 4)))
+	                             | (GPIO_PORT_INDEX(GPIOx) << ((pin_no % 4) * 4));
+	exti_ports[pin_no] = GPIOx;
+	exti_stable_levels = (exti_stable_levels & ~(1U << pin_no)) | (hal_gpio_read_from_pin(GPIOx, pin_no) << pin_no);
+	
+	if (edge_sel == INT_RISING_EDGE)
+	{
+		exti_rising_lines |= (1U << pin_no);
+		exti_falling_lines &= ~(1U << pin_no);
+	}
+	else if (edge_sel == INT_FALLING_EDGE)
+	{
+		exti_falling_lines |= (1U << pin_no);
+		exti_rising_lines &= ~(1U << pin_no);
+	}
+	else
+	{
+		exti_rising_lines |= (1U << pin_no);
+		exti_falling_lines |= (1U << pin_no);
+	}
+	hal_gpio_exti_apply_edges(pin_no);
+}
+
+/**
+  * @brief   Unmasks the EXTI line and enables its interrupt in the NVIC
+  * @param   pin_no   : GPIO pin number
+  * @param   priority : NVIC priority of the line's IRQ (EXTI5-9 and EXTI10-15 share one IRQ each)
+  * @retval  None
+  */
+
+void hal_gpio_enable_interrupt(uint16_t pin_no, uint32_t priority)
+{
+	IRQn_Type irq_no;
+	
+	if (pin_no <= 4)
+	{
+		irq_no = (IRQn_Type)(EXTI0_IRQn + pin_no);
+	}
+	else if (pin_no <= 9)
+	{
+		irq_no = EXTI9_5_IRQn;
+	}
+	else
+	{
+		irq_no = EXTI15_10_IRQn;
+	}
+	
+	hal_gpio_clear_interrupt(pin_no);
+	hal_gpio_exti_unmask(1U << pin_no);
+	NVIC_SetPriority(irq_no, priority);
+	NVIC_EnableIRQ(irq_no);
+}
+
+/**
+  * @brief   Masks the EXTI line of a pin
+  * @param   pin_no : GPIO pin number
+  * @retval  None
+  */
+
+void hal_gpio_disable_interrupt(uint16_t pin_no)
+{
+	uint32_t primask = __get_PRIMASK();
+	
+	__disable_irq();
+	EXTI->IMR &= ~(1U << pin_no);
+	exti_settling_lines &= ~(1U << pin_no);
+	__set_PRIMASK(primask);
+}
+
+/**
+  * @brief   Clears the pending bit of the EXTI line of a pin
+  * @param   pin_no : GPIO pin number
+  * @retval  None
+  */
+
+void hal_gpio_clear_interrupt(uint16_t pin_no)
+{
+	/* Write 1 to clear, the other lines are not affected */
+	EXTI->PR = (1U << pin_no);
+}
+
+/**
+  * @brief   Registers the callback of an EXTI line
+  * @param   pin_no   : GPIO pin number
+  * @param   callback : function to call, NULL to remove
+  * @param   debounce : 1 to call it through the debounce stage, 0 to call it on every edge
+  * @retval  None
+  */
+
+void hal_gpio_register_callback(uint16_t pin_no, hal_gpio_exti_callback_t callback, uint8_t debounce)
+{
+	exti_callbacks[pin_no] = callback;
+	
+	if (debounce)
+	{
+		exti_debounce_lines |= (1U << pin_no);
+	}
+	else
+	{
+		exti_debounce_lines &= ~(1U << pin_no);
+	}
+	hal_gpio_exti_apply_edges(pin_no);
+}
+
+/**
+  * @brief   Sets up the debounce timer
+  * @param   debounce_ms : settle time after the first edge, 1 - 6553 ms
+  * @param   priority    : NVIC priority of the timer IRQ
+  * @retval  None
+  */
+
+void hal_gpio_debounce_init(uint32_t debounce_ms, uint32_t priority)
+{
+	RCC->APB2ENR |= RCC_APB2ENR_TIM11EN;
+	
+	GPIO_DEBOUNCE_TIMER->CR1 = TIM_CR1_URS;               /* Only an overflow raises the update interrupt */
+	GPIO_DEBOUNCE_TIMER->PSC = SystemCoreClock / GPIO_DEBOUNCE_TICK_HZ - 1;
+	GPIO_DEBOUNCE_TIMER->ARR = debounce_ms * (GPIO_DEBOUNCE_TICK_HZ / 1000) - 1;
+	GPIO_DEBOUNCE_TIMER->EGR = TIM_EGR_UG;                /* Load the prescaler */
+	GPIO_DEBOUNCE_TIMER->SR = 0;
+	GPIO_DEBOUNCE_TIMER->DIER = TIM_DIER_UIE;
+	
+	NVIC_SetPriority(GPIO_DEBOUNCE_TIMER_IRQn, priority);
+	NVIC_EnableIRQ(GPIO_DEBOUNCE_TIMER_IRQn);
+}
+
+
+
+/**
+  * @brief   Takes TIM1 for a user, safe against the DMA handlers that release it
+  * @param   owner : user taking the timer
+  * @retval  uint8_t: 1 if taken, 0 if TIM1 is already owned (also by the same user)
+  */
+
+uint8_t hal_gpio_tim1_claim(gpio_tim1_owner_t owner)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint8_t taken = 0;
+	
+	__disable_irq();
+	if (tim1_owner == GPIO_TIM1_FREE)
+	{
+		tim1_owner = owner;
+		taken = 1;
+	}
+	__set_PRIMASK(primask);
+	return taken;
+}
+
+/**
+  * @brief   Gives TIM1 back, only if the user owns it
+  * @param   owner : user releasing the timer
+  * @retval  None
+  */
+
+void hal_gpio_tim1_release(gpio_tim1_owner_t owner)
+{
+	uint32_t primask = __get_PRIMASK();
+	
+	__disable_irq();
+	if (tim1_owner == owner)
+	{
+		tim1_owner = GPIO_TIM1_FREE;
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+  * @brief   Splits a TIM1 update rate into prescaler and auto-reload values, TIM1 clocked at SystemCoreClock
+  * @param   rate_hz : update events per second
+  * @param   *psc    : prescaler value
+  * @param   *arr    : auto-reload value
+  * @retval  uint8_t: 1 if the rate can be reached, 0 for 0 Hz or above SystemCoreClock / 2 (ARR 0 stops the counter)
+  */
+
+uint8_t hal_gpio_tim1_rate(uint32_t rate_hz, uint32_t *psc, uint32_t *arr)
+{
+	uint32_t ticks;
+	
+	if (rate_hz == 0)
+	{
+		return 0;
+	}
+	ticks = SystemCoreClock / rate_hz;
+	if (ticks < 2)
+	{
+		return 0;
+	}
+	
+	/* Smallest prescaler that fits ARR in 16 bits keeps the rate error lowest */
+	*psc = (ticks - 1) >> 16;
+	*arr = SystemCoreClock / ((*psc + 1) * rate_hz) - 1;
+	return 1;
+}
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Interrupt handlers                                                                                                                    */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+void EXTI0_IRQHandler(void)
+{
+	hal_gpio_exti_dispatch(1U << 0);
+}
+
+void EXTI1_IRQHandler(void)
+{
+	hal_gpio_exti_dispatch(1U << 1);
+}
+
+void EXTI2_IRQHandler(void)
+{
+	hal_gpio_exti_dispatch(1U << 2);
+}
+
+void EXTI3_IRQHandler(void)
+{
+	hal_gpio_exti_dispatch(1U << 3);
+}
+
+void EXTI4_IRQHandler(void)
+{
+	hal_gpio_exti_dispatch(1U << 4);
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+	hal_gpio_exti_dispatch(0x03E0U);
+}
+
+void EXTI15_10_IRQHandler(void)
+{
+	hal_gpio_exti_dispatch(0xFC00U);
+}
+
+/**
+  * @brief   Debounce delay expired: report the lines whose settled level changed on a selected edge, unmask them
+  * @param   None
+  * @retval  None
+  */
+
+void TIM1_TRG_COM_TIM11_IRQHandler(void)
+{
+	uint32_t lines, line, level, primask;
+	
+	GPIO_DEBOUNCE_TIMER->SR = ~(uint32_t)TIM_SR_UIF;          /* rc_w0, the other flags are kept */
+	
+	/* Stop the timer and take the lines in one step: an edge after this restarts the timer and waits its full delay */
+	primask = __get_PRIMASK();
+	__disable_irq();
+	GPIO_DEBOUNCE_TIMER->CR1 &= ~TIM_CR1_CEN;
+	lines = exti_settling_lines;
+	exti_settling_lines = 0;
+	__set_PRIMASK(primask);
+	
+	for (line = 0; lines; line++, lines >>= 1)
+	{
+		if (!(lines & 1U))
+		{
+			continue;
+		}
+		
+		/* No port before hal_gpio_configure_interrupt(), nothing to read: the line is only unmasked again */
+		level = exti_ports[line] ? hal_gpio_read_from_pin(exti_ports[line], line) : ((exti_stable_levels >> line) & 1U);
+		
+		if (level != ((exti_stable_levels >> line) & 1U))
+		{
+			exti_stable_levels ^= (1U << line);
+			if (exti_callbacks[line] && ((level ? exti_rising_lines : exti_falling_lines) & (1U << line)))
+			{
+				exti_callbacks[line](line, level);
+			}
+		}
+		/* Edges seen while masked were bounces */
+		EXTI->PR = (1U << line);
+		hal_gpio_exti_unmask(1U << line);
+	}
+}
@@ -0,0 +1,292 @@
+#ifndef _HAL_GPIO_DRIVER_H
+#define _HAL_GPIO_DRIVER_H
+
+#include "stm32f411xe.h"  
+#include "hal_gpio_fast.h"
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     1. Macros used for GPIO Initialization                                                                                                */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+
+/* GPIO Mode Settings values*/
+#define GPIO_PIN_INPUT_MODE                                            ((uint32_t)0x00)
+#define GPIO_PIN_OUTPUT_MODE                                           ((uint32_t)0x01)
+#define GPIO_PIN_ALT_FUN_MODE                                          ((uint32_t)0x02)
+#define GPIO_PIN_ANALOG_MODE                                           ((uint32_t)0x03)
+
+
+/* GPIO OP type settings values*/  
+#define GPIO_PIN_OP_TYPE_PUSHPULL                                      ((uint32_t)0x00)
+#define GPIO_PIN_OP_TYPE_OPEN_DRAIN                                    ((uint32_t)0x01)
+
+
+/* GPIO Port Output Speed values*/ 
+#define GPIO_PIN_SPEED_LOW                                             ((uint32_t)0x00)
+#define GPIO_PIN_SPEED_MED                                             ((uint32_t)0x01)
+#define GPIO_PIN_SPEED_FAST                                            ((uint32_t)0x02)
+#define GPIO_PIN_SPEED_HIGH                                            ((uint32_t)0x03)
+
+
+/* GPIO Port Pull-up Pull-down setting values*/ 
+#define GPIO_PIN_NO_PUSH_PULL                                          ((uint32_t)0x00)
+#define GPIO_PIN_PULL_UP                                               ((uint32_t)0x01)
+#define GPIO_PIN_PULL_DOWN                                             ((uint32_t)0x02)
+
+/* GPIO PORT ADDRESS */
+#define GPIO_PORT_A   GPIOA
+#define GPIO_PORT_B   GPIOB
+#define GPIO_PORT_C   GPIOC
+#define GPIO_PORT_D   GPIOD
+#define GPIO_PORT_E   GPIOE
+#define GPIO_PORT_H   GPIOH
+
+/* Macros to enable clock for different GPIO ports in RCC registers */
+
+#define _HAL_RCC_GPIOA_CLK_ENABLE()         (RCC->AHB1ENR |= (1<<0))
+#define _HAL_RCC_GPIOB_CLK_ENABLE()         (RCC->AHB1ENR |= (1<<1))
+#define _HAL_RCC_GPIOC_CLK_ENABLE()         (RCC->AHB1ENR |= (1<<2))
+#define _HAL_RCC_GPIOD_CLK_ENABLE()         (RCC->AHB1ENR |= (1<<3))
+#define _HAL_RCC_GPIOE_CLK_ENABLE()         (RCC->AHB1ENR |= (1<<4))
+#define _HAL_RCC_GPIOH_CLK_ENABLE()         (RCC->AHB1ENR |= (1<<7))
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Data Structure for GPIO Initialization                                                                                                */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+* @brief   GPIO pin configuration structure
+*          This structure will be filled and passed to driver by the application to initialize the GPIO pin
+*
+*/
+
+typedef struct
+{
+  uint32_t pin;                          /*Specifies the GPIO pins to be configured */
+  uint32_t mode;                         /*Specifies the operating mode for the specified pin */
+  uint32_t op_type;                      /*Specifies the output type for the selected pins */
+  uint32_t pull;                         /*Specifies the Pull-up or Pull-down activation for the selected pins */
+  uint32_t speed;                        /*Specifies the speed of the selected pins */
+	uint32_t alternate;                    /*Specifies the alternate functionality for the selected pins */
+}gpio_pin_conf_t;
+
+/**
+* @brief   Board pin table entry
+*          A const array of these describes every pin of the board, see hal_gpio_init_board()
+*
+*/
+
+typedef struct
+{
+  GPIO_TypeDef *port;                    /*GPIO Port Base address */
+  gpio_pin_conf_t conf;                  /*Configuration of the pin, conf.pin is the pin number */
+}gpio_board_pin_t;
+
+/**
+* @brief   Interrupt edge selection enum
+*
+*/
+
+typedef enum
+{
+	INT_RISING_EDGE,
+	INT_FALLING_EDGE,
+	INT_RISING_FALLING_EDGE
+}int_edge_sel_t;
+
+/**
+* @brief   EXTI line callback, called from interrupt context with the pin number and its level
+*          (the settled level when the line is debounced)
+*
+*/
+
+typedef void (*hal_gpio_exti_callback_t)(uint16_t pin_no, uint8_t level);
+	
+	
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Initializes the gpio pin
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   *gpio_pin_conf : Pointer to the pin conf structure sent by application
+  * @retval  None
+  */
+
+void hal_gpio_init(GPIO_TypeDef *GPIOx, gpio_pin_conf_t *gpio_pin_conf);
+
+/**
+  * @brief   Read a value from a given pin number
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   pin_no : GPIO pin number
+  * @retval  uint8_t: Value read
+  */
+
+uint8_t hal_gpio_read_from_pin(GPIO_TypeDef *GPIOx, uint16_t pin_no);
+
+/**
+  * @brief   Write a value to a given pin number
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   pin_no : GPIO pin number
+  * @param   uint8_t: Value to be written
+  * @retval  None
+	*/
+
+void hal_gpio_write_to_pin(GPIO_TypeDef *GPIOx, uint16_t pin_no, uint8_t val);
+
+/**
+  * @brief   Set the alternate functionality for the given pin number
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   pin_no : GPIO pin number
+  * @param   alt_fun_value: Alternate function to be configured with
+  * @retval  None
+	*/
+void hal_gpio_set_alt_function(GPIO_TypeDef *GPIOx, uint16_t pin_no, uint16_t alt_fun_value);
+
+/**
+  * @brief   Configures a whole table of pins and enables the clocks of their ports
+  *          The table is folded into one value per register per port, then MODER, OTYPER, OSPEEDR, PUPDR
+  *          and AFR of each port get a single masked write, whatever the number of pins
+  * @param   *table : board pin table
+  * @param   count  : number of entries
+  * @retval  None
+  */
+
+void hal_gpio_init_board(const gpio_board_pin_t *table, uint32_t count);
+
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     External interrupts                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/*
+ *  EXTI line n serves pin n of one port, chosen by the SYSCFG EXTICR mapping. The driver owns the EXTI0-4, EXTI9_5 and
+ *  EXTI15_10 interrupt handlers and calls the callback registered for each pending line.
+ *
+ *  A debounced line is masked on its first edge and a one-shot TIM11 delay is started; when it expires the pin is read
+ *  once, the callback runs only if the level changed and matches the configured edge, and the line is unmasked. A
+ *  bouncing contact therefore costs one interrupt per press instead of a polling loop. It triggers on both edges in
+ *  EXTI whatever the configured edge, so the settled level also follows the releases.
+ */
+
+/* Debounce timer, clocked from APB2 (SystemCoreClock with the reset prescalers) */
+#define GPIO_DEBOUNCE_TIMER                 TIM11
+#define GPIO_DEBOUNCE_TIMER_IRQn            TIM1_TRG_COM_TIM11_IRQn
+#define GPIO_DEBOUNCE_TICK_HZ               10000U
+
+/**
+  * @brief   Configures the edge and the port of the EXTI line of a pin, enables the SYSCFG clock
+  * @param   *GPIOx   : GPIO Port Base address
+  * @param   pin_no   : GPIO pin number, also the EXTI line number
+  * @param   edge_sel : triggering edge selection value of type "int_edge_sel_t"
+  * @retval  None
+  */
+
+void hal_gpio_configure_interrupt(GPIO_TypeDef *GPIOx, uint16_t pin_no, int_edge_sel_t edge_sel);
+
+/**
+  * @brief   Unmasks the EXTI line and enables its interrupt in the NVIC
+  * @param   pin_no   : GPIO pin number
+  * @param   priority : NVIC priority of the line's IRQ (EXTI5-9 and EXTI10-15 share one IRQ each)
+  * @retval  None
+  */
+
+void hal_gpio_enable_interrupt(uint16_t pin_no, uint32_t priority);
+
+/**
+  * @brief   Masks the EXTI line of a pin
+  * @param   pin_no : GPIO pin number
+  * @retval  None
+  */
+
+void hal_gpio_disable_interrupt(uint16_t pin_no);
+
+/**
+  * @brief   Clears the pending bit of the EXTI line of a pin
+  * @param   pin_no : GPIO pin number
+  * @retval  None
+  */
+
+void hal_gpio_clear_interrupt(uint16_t pin_no);
+
+/**
+  * @brief   Registers the callback of an EXTI line
+  * @param   pin_no   : GPIO pin number
+  * @param   callback : function to call, NULL to remove
+  * @param   debounce : 1 to call it through the debounce stage, 0 to call it on every edge
+  * @retval  None
+  */
+
+void hal_gpio_register_callback(uint16_t pin_no, hal_gpio_exti_callback_t callback, uint8_t debounce);
+
+/**
+  * @brief   Sets up the debounce timer
+  * @param   debounce_ms : settle time after the first edge, 1 - 6553 ms
+  * @param   priority    : NVIC priority of the timer IRQ
+  * @retval  None
+  */
+
+void hal_gpio_debounce_init(uint32_t debounce_ms, uint32_t priority);
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     TIM1 ownership                                                                                                                        */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/*
+ *  TIM1 paces both the waveform generator (hal_gpio_wave.h) and the logic sampler (hal_gpio_sampler.h). Each one claims
+ *  it in its start function and releases it once stopped, so only one of them programs and runs the timer at a time.
+ */
+
+/**
+* @brief   Users of TIM1
+*
+*/
+
+typedef enum
+{
+	GPIO_TIM1_FREE = 0,
+	GPIO_TIM1_WAVE,
+	GPIO_TIM1_SAMPLER
+}gpio_tim1_owner_t;
+
+/**
+  * @brief   Takes TIM1 for a user, safe against the DMA handlers that release it
+  * @param   owner : user taking the timer
+  * @retval  uint8_t: 1 if taken, 0 if TIM1 is already owned (also by the same user)
+  */
+
+uint8_t hal_gpio_tim1_claim(gpio_tim1_owner_t owner);
+
+/**
+  * @brief   Gives TIM1 back, only if the user owns it
+  * @param   owner : user releasing the timer
+  * @retval  None
+  */
+
+void hal_gpio_tim1_release(gpio_tim1_owner_t owner);
+
+/**
+  * @brief   Splits a TIM1 update rate into prescaler and auto-reload values, TIM1 clocked at SystemCoreClock
+  * @param   rate_hz : update events per second
+  * @param   *psc    : prescaler value
+  * @param   *arr    : auto-reload value
+  * @retval  uint8_t: 1 if the rate can be reached, 0 for 0 Hz or above SystemCoreClock / 2 (ARR 0 stops the counter)
+  */
+
+uint8_t hal_gpio_tim1_rate(uint32_t rate_hz, uint32_t *psc, uint32_t *arr);
+
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef _HAL_GPIO_FAST_H
+#define _HAL_GPIO_FAST_H
+
+#include <stdint.h>
+#include "stm32f411xe.h"
+
+/*
+ *  Inline GPIO fast paths shared by every project of the board: bit-band aliases, port-wide BSRR access and
+ *  compile-time pin descriptors. Only the CMSIS device header is needed, so code built on the ST HAL can include this
+ *  file without linking hal_gpio_driver.c (which owns the EXTI handlers). hal_gpio_driver.h includes it.
+ */
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Bit-band access                                                                                                                       */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/*
+ *  Each bit of the peripheral region (0x40000000 - 0x400FFFFF) has a word alias in the bit-band region at
+ *  PERIPH_BB_BASE + (register offset * 32) + (bit * 4). Reading the alias returns the bit as 0 or 1, writing bit 0 of
+ *  the alias sets or clears the bit in one locked read-modify-write of the bus, which an interrupt cannot split.
+ *  No shift, mask or branch is left in the code.
+ *
+ *      HAL_BITBAND_PERIPH(GPIOD->ODR, 12) = 1;               PD12 high
+ *      while (!HAL_BITBAND_PERIPH(USART2->SR, 7));          wait for TXE
+ *
+ *  Only for registers of the peripheral region; bits must be 0-31.
+ */
+
+/* Alias address of bit `bit` of the peripheral register at address `reg_addr` */
+#define HAL_BITBAND_PERIPH_ADDR(reg_addr, bit)   (PERIPH_BB_BASE + (((uint32_t)(reg_addr) - PERIPH_BASE) * 32U) + ((uint32_t)(bit) * 4U))
+
+/* Alias of bit `bit` of peripheral register `reg`, usable as an lvalue */
+#define HAL_BITBAND_PERIPH(reg, bit)             (*(volatile uint32_t *)HAL_BITBAND_PERIPH_ADDR(&(reg), (bit)))
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Port-wide atomic access                                                                                                               */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/*
+ *  Every pin of the mask is updated by one store to BSRR: bits 0-15 set the pin, bits 16-31 reset it, zero bits leave
+ *  the pin alone. Pins outside the mask are never touched, so these are safe against interrupt handlers that drive
+ *  other pins of the same port.
+ */
+
+/**
+  * @brief   Drives the pins of a mask high
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   mask   : pins to set, bit n is pin n
+  * @retval  None
+  */
+
+static inline void hal_gpio_set_pins(GPIO_TypeDef *GPIOx, uint16_t mask)
+{
+	GPIOx->BSRR = mask;
+}
+
+/**
+  * @brief   Drives the pins of a mask low
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   mask   : pins to clear, bit n is pin n
+  * @retval  None
+  */
+
+static inline void hal_gpio_clear_pins(GPIO_TypeDef *GPIOx, uint16_t mask)
+{
+	GPIOx->BSRR = (uint32_t)mask << 16;
+}
+
+/**
+  * @brief   Writes a value to the pins of a mask, e.g. a parallel bus
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   mask   : pins to write, bit n is pin n
+  * @param   value  : level of each pin of the mask
+  * @retval  None
+  */
+
+static inline void hal_gpio_write_pins(GPIO_TypeDef *GPIOx, uint16_t mask, uint16_t value)
+{
+	GPIOx->BSRR = ((uint32_t)(mask & ~value) << 16) | (mask & value);
+}
+
+/*
+ *  Toggling goes through one snapshot of ODR: the pins of the mask that are high get their reset bit, the others their
+ *  set bit, and the whole word is written to BSRR in one store. Nothing is read back and written to ODR, so an interrupt
+ *  that changes another pin of the port between the snapshot and the store is never undone; no lock is needed. Only
+ *  two writers toggling the same pin can still race, as with any toggle.
+ *
+ *  A snapshot also restores a group of pins, e.g. around a blink pattern:
+ *
+ *      uint16_t leds = hal_gpio_snapshot(GPIOD);
+ *      ...
+ *      hal_gpio_write_pins(GPIOD, LED_ALL_MASK, leds);
+ */
+
+/**
+  * @brief   Takes a snapshot of the output latch of a port
+  * @param   *GPIOx : GPIO Port Base address
+  * @retval  uint16_t: ODR, bit n is the driven level of pin n
+  */
+
+static inline uint16_t hal_gpio_snapshot(GPIO_TypeDef *GPIOx)
+{
+	return (uint16_t)GPIOx->ODR;
+}
+
+/**
+  * @brief   BSRR word that inverts the pins of a mask, computed from an ODR snapshot
+  * @param   odr  : snapshot of the output latch
+  * @param   mask : pins to invert, bit n is pin n
+  * @retval  uint32_t: reset bits for the high pins, set bits for the low pins
+  */
+
+static inline uint32_t hal_gpio_toggle_word(uint16_t odr, uint16_t mask)
+{
+	return ((uint32_t)(odr & mask) << 16) | (uint16_t)(~odr & mask);
+}
+
+/**
+  * @brief   Toggles the pins of a mask
+  *          ODR is read once to pick set or reset per pin, the update itself is still one store
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   mask   : pins to toggle, bit n is pin n
+  * @retval  None
+  */
+
+static inline void hal_gpio_toggle_pins(GPIO_TypeDef *GPIOx, uint16_t mask)
+{
+	GPIOx->BSRR = hal_gpio_toggle_word(hal_gpio_snapshot(GPIOx), mask);
+}
+
+/**
+  * @brief   Toggles one pin, see hal_gpio_toggle_pins()
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   pin_no : GPIO pin number
+  * @retval  None
+  */
+
+static inline void hal_gpio_toggle_pin(GPIO_TypeDef *GPIOx, uint16_t pin_no)
+{
+	hal_gpio_toggle_pins(GPIOx, (uint16_t)(1U << pin_no));
+}
+
+/**
+  * @brief   Reads the input level of the pins of a mask
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   mask   : pins to read, bit n is pin n
+  * @retval  uint16_t: IDR bits of the mask, other bits are 0
+  */
+
+static inline uint16_t hal_gpio_read_pins(GPIO_TypeDef *GPIOx, uint16_t mask)
+{
+	return (uint16_t)(GPIOx->IDR & mask);
+}
+
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Compile-time pin descriptors                                                                                                          */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/*
+ *  GPIO_PIN_DEFINE(name, port_base, pin_no) generates static inline accessors for one pin whose port and number are
+ *  known at compile time. With a constant port base address (GPIOx_BASE) and pin number every accessor folds to a
+ *  single store to, or load from, a constant address:
+ *
+ *      GPIO_PIN_DEFINE(led_green, GPIOD_BASE, 12)
+ *
+ *      led_green_set();        GPIOD->BSRR = 1 << 12
+ *      led_green_clear();      GPIOD->BSRR = 1 << 28
+ *      led_green_write(val);   set or clear
+ *      led_green_toggle();     ODR read + one BSRR store
+ *      led_green_read();       IDR bit 12
+ */
+
+#define GPIO_PIN_DEFINE(name, port_base, pin_no)                                                                          \
+	static inline void name##_set(void)        { ((GPIO_TypeDef *)(port_base))->BSRR = (1U << (pin_no)); }              \
+	static inline void name##_clear(void)      { ((GPIO_TypeDef *)(port_base))->BSRR = (1U << ((pin_no) + 16)); }       \
+	static inline void name##_write(uint8_t val)                                                                        \
+	{                                                                                                                   \
+		((GPIO_TypeDef *)(port_base))->BSRR = (1U << ((pin_no) + (val ? 0 : 16)));                                        \
+	}                                                                                                                   \
+	static inline void name##_toggle(void)                                                                              \
+	{                                                                                                                   \
+		hal_gpio_toggle_pins((GPIO_TypeDef *)(port_base), (uint16_t)(1U << (pin_no)));                                    \
+	}                                                                                                                   \
+	static inline uint8_t name##_read(void)    { return (((GPIO_TypeDef *)(port_base))->IDR >> (pin_no)) & 0x1U; }
+
+
+#endif
@@ -0,0 +1,327 @@
+#include <stdint.h>
+#include "hal_gpio_sampler.h"
+
+
+/* DMA2 Stream1 flags in LISR/LIFCR */
+#define GPIO_SAMPLER_DMA_FLAGS    (DMA_LIFCR_CFEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CTEIF1 | DMA_LIFCR_CHTIF1 | DMA_LIFCR_CTCIF1)
+
+/* Largest record: tag + value + 5 byte varint */
+#define GPIO_SAMPLER_RECORD_MAX   8U
+
+static uint16_t sampler_ring[GPIO_SAMPLER_RING_LEN];
+static volatile uint32_t sampler_wraps;                /* Ring wraps counted by the DMA interrupt */
+static volatile uint8_t sampler_running;
+static uint32_t sampler_rate_hz;
+static uint32_t sampler_prescaler;                     /* TIM1 PSC and ARR, loaded when sampling starts */
+static uint32_t sampler_period;                        /* 0 until a valid rate is set */
+static uint32_t sampler_consumed;                      /* Samples read since start */
+static uint16_t sampler_mask;
+static uint16_t sampler_value;                         /* Run being counted */
+static uint32_t sampler_run;
+static gpio_sampler_write_t sampler_write;
+
+/* Output is batched so the write function is not called per record */
+static uint8_t sampler_out[64];
+static uint32_t sampler_out_len;
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Static helper functions                                                                                                               */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Writes the batched output
+  * @param   None
+	* @retval  None
+  */
+
+static void hal_gpio_sampler_flush(void)
+{
+	if (sampler_out_len)
+	{
+		sampler_write(sampler_out, sampler_out_len);
+		sampler_out_len = 0;
+	}
+}
+
+/**
+  * @brief   Appends a varint
+  * @param   value : number to encode
+	* @retval  None
+  */
+
+static void hal_gpio_sampler_put_varint(uint32_t value)
+{
+	while (value >= 0x80U)
+	{
+		sampler_out[sampler_out_len++] = (uint8_t)(value | 0x80U);
+		value >>= 7;
+	}
+	sampler_out[sampler_out_len++] = (uint8_t)value;
+}
+
+/**
+  * @brief   Appends a run record
+  * @param   value : masked port value
+  * @param   count : samples it was held for
+	* @retval  None
+  */
+
+static void hal_gpio_sampler_put_run(uint16_t value, uint32_t count)
+{
+	if (sampler_out_len > sizeof(sampler_out) - GPIO_SAMPLER_RECORD_MAX)
+	{
+		hal_gpio_sampler_flush();
+	}
+	sampler_out[sampler_out_len++] = GPIO_SAMPLER_TAG_RUN;
+	sampler_out[sampler_out_len++] = (uint8_t)value;
+	sampler_out[sampler_out_len++] = (uint8_t)(value >> 8);
+	hal_gpio_sampler_put_varint(count);
+}
+
+/**
+  * @brief   Samples written by the DMA since start, consistent with the wrap counter
+  * @param   None
+	* @retval  uint32_t: samples produced
+  */
+
+static uint32_t hal_gpio_sampler_produced(void)
+{
+	uint32_t wraps, ndtr, wrap_pending;
+	
+	/* A wrap the interrupt has not counted yet shows as TCIF1; read again if a wrap happened between the reads */
+	do
+	{
+		wraps = sampler_wraps;
+		wrap_pending = DMA2->LISR & DMA_LISR_TCIF1;
+		ndtr = GPIO_SAMPLER_DMA_STREAM->NDTR;
+	} while (wraps != sampler_wraps || wrap_pending != (DMA2->LISR & DMA_LISR_TCIF1));
+	
+	if (wrap_pending)
+	{
+		wraps++;
+	}
+	return wraps * GPIO_SAMPLER_RING_LEN + (GPIO_SAMPLER_RING_LEN - ndtr);
+}
+
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Enables the TIM1 and DMA2 clocks and sets the sample rate
+  * @param   sample_rate_hz : samples per second
+  * @param   priority       : NVIC priority of the DMA interrupt (counts ring wraps)
+  * @retval  uint8_t: 1 if the rate is valid, 0 for 0 Hz or above SystemCoreClock / 2 (hal_gpio_sampler_start() then fails)
+  */
+
+uint8_t hal_gpio_sampler_init(uint32_t sample_rate_hz, uint32_t priority)
+{
+	RCC->APB2ENR |= RCC_APB2ENR_TIM1EN;
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+	
+	NVIC_SetPriority(GPIO_SAMPLER_DMA_IRQn, priority);
+	NVIC_EnableIRQ(GPIO_SAMPLER_DMA_IRQn);
+	
+	/* TIM1 may be running for the waveform generator, it is only programmed by hal_gpio_sampler_start() */
+	sampler_rate_hz = sample_rate_hz;
+	if (!hal_gpio_tim1_rate(sample_rate_hz, &sampler_prescaler, &sampler_period))
+	{
+		sampler_period = 0;
+		return 0;
+	}
+	return 1;
+}
+
+/**
+  * @brief   Starts sampling a port and writes the stream header
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   mask   : pins to record, the others read as 0
+  * @param   write  : output function for the compressed stream
+  * @retval  uint8_t: 1 if started, 0 if already running, the waveform generator holds TIM1 or the rate passed to
+  *          hal_gpio_sampler_init() was invalid
+  */
+
+uint8_t hal_gpio_sampler_start(GPIO_TypeDef *GPIOx, uint16_t mask, gpio_sampler_write_t write)
+{
+	uint32_t port = ((uint32_t)GPIOx - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE);
+	
+	if (sampler_period == 0 || !hal_gpio_tim1_claim(GPIO_TIM1_SAMPLER))
+	{
+		return 0;
+	}
+	sampler_running = 1;
+	sampler_write = write;
+	sampler_mask = mask;
+	sampler_wraps = 0;
+	sampler_consumed = 0;
+	sampler_run = 0;
+	sampler_out_len = 0;
+	
+	/* Stream header */
+	sampler_out[sampler_out_len++] = 'L';
+	sampler_out[sampler_out_len++] = 'A';
+	sampler_out[sampler_out_len++] = GPIO_SAMPLER_VERSION;
+	sampler_out[sampler_out_len++] = (uint8_t)port;
+	sampler_out[sampler_out_len++] = (uint8_t)sampler_rate_hz;
+	sampler_out[sampler_out_len++] = (uint8_t)(sampler_rate_hz >> 8);
+	sampler_out[sampler_out_len++] = (uint8_t)(sampler_rate_hz >> 16);
+	sampler_out[sampler_out_len++] = (uint8_t)(sampler_rate_hz >> 24);
+	sampler_out[sampler_out_len++] = (uint8_t)mask;
+	sampler_out[sampler_out_len++] = (uint8_t)(mask >> 8);
+	hal_gpio_sampler_flush();
+	
+	GPIO_SAMPLER_DMA_STREAM->CR &= ~DMA_SxCR_EN;
+	while (GPIO_SAMPLER_DMA_STREAM->CR & DMA_SxCR_EN);
+	DMA2->LIFCR = GPIO_SAMPLER_DMA_FLAGS;
+	
+	GPIO_SAMPLER_DMA_STREAM->PAR = (uint32_t)&GPIOx->IDR;
+	GPIO_SAMPLER_DMA_STREAM->M0AR = (uint32_t)sampler_ring;
+	GPIO_SAMPLER_DMA_STREAM->NDTR = GPIO_SAMPLER_RING_LEN;
+	GPIO_SAMPLER_DMA_STREAM->FCR = 0;                     /* Direct mode, halfword to halfword */
+	
+	/* Peripheral to memory, halfword sizes, memory increment, circular, high priority, wrap + error interrupts */
+	GPIO_SAMPLER_DMA_STREAM->CR = (GPIO_SAMPLER_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_0 |
+	                              DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+	GPIO_SAMPLER_DMA_STREAM->CR |= DMA_SxCR_EN;
+	
+	GPIO_SAMPLER_TIMER->CR1 = TIM_CR1_URS;
+	GPIO_SAMPLER_TIMER->PSC = sampler_prescaler;
+	GPIO_SAMPLER_TIMER->ARR = sampler_period;
+	GPIO_SAMPLER_TIMER->EGR = TIM_EGR_UG;
+	
+	/* Channel 1 frozen output compare at 0: one CC1 DMA request per period */
+	GPIO_SAMPLER_TIMER->CCMR1 &= ~(TIM_CCMR1_CC1S | TIM_CCMR1_OC1M);
+	GPIO_SAMPLER_TIMER->CCR1 = 0;
+	
+	GPIO_SAMPLER_TIMER->SR = 0;
+	GPIO_SAMPLER_TIMER->DIER = TIM_DIER_CC1DE;
+	GPIO_SAMPLER_TIMER->CCER |= TIM_CCER_CC1E;
+	GPIO_SAMPLER_TIMER->CR1 |= TIM_CR1_CEN;
+	return 1;
+}
+
+/**
+  * @brief   Compresses the samples taken since the last call and writes the finished runs
+  * @param   None
+  * @retval  uint32_t: samples consumed
+  */
+
+uint32_t hal_gpio_sampler_process(void)
+{
+	uint32_t produced = hal_gpio_sampler_produced();
+	uint32_t count, total, idx, lost;
+	uint16_t value;
+	
+	if (!sampler_write)
+	{
+		return 0;
+	}
+	
+	/* The DMA lapped the reader: close the current run and report the gap */
+	if (produced - sampler_consumed > GPIO_SAMPLER_RING_LEN)
+	{
+		lost = produced - sampler_consumed - GPIO_SAMPLER_RING_LEN;
+		if (sampler_run)
+		{
+			hal_gpio_sampler_put_run(sampler_value, sampler_run);
+			sampler_run = 0;
+		}
+		if (sampler_out_len > sizeof(sampler_out) - GPIO_SAMPLER_RECORD_MAX)
+		{
+			hal_gpio_sampler_flush();
+		}
+		sampler_out[sampler_out_len++] = GPIO_SAMPLER_TAG_OVERRUN;
+		hal_gpio_sampler_put_varint(lost);
+		sampler_consumed += lost;
+	}
+	
+	count = produced - sampler_consumed;
+	total = count;
+	idx = sampler_consumed % GPIO_SAMPLER_RING_LEN;
+	sampler_consumed = produced;
+	
+	while (count--)
+	{
+		value = sampler_ring[idx] & sampler_mask;
+		if (++idx == GPIO_SAMPLER_RING_LEN)
+		{
+			idx = 0;
+		}
+		
+		if (sampler_run && value == sampler_value && sampler_run < GPIO_SAMPLER_MAX_RUN)
+		{
+			sampler_run++;
+			continue;
+		}
+		if (sampler_run)
+		{
+			hal_gpio_sampler_put_run(sampler_value, sampler_run);
+		}
+		sampler_value = value;
+		sampler_run = 1;
+	}
+	hal_gpio_sampler_flush();
+	return total;
+}
+
+/**
+  * @brief   Stops sampling, processes the remaining samples and writes the last run
+  * @param   None
+  * @retval  None
+  */
+
+void hal_gpio_sampler_stop(void)
+{
+	/* TIM1 may belong to the waveform generator */
+	if (!sampler_running)
+	{
+		return;
+	}
+	GPIO_SAMPLER_TIMER->CR1 &= ~TIM_CR1_CEN;
+	GPIO_SAMPLER_TIMER->DIER &= ~TIM_DIER_CC1DE;
+	GPIO_SAMPLER_TIMER->CCER &= ~TIM_CCER_CC1E;
+	GPIO_SAMPLER_DMA_STREAM->CR &= ~DMA_SxCR_EN;
+	while (GPIO_SAMPLER_DMA_STREAM->CR & DMA_SxCR_EN);
+	
+	hal_gpio_sampler_process();
+	if (sampler_run)
+	{
+		hal_gpio_sampler_put_run(sampler_value, sampler_run);
+		sampler_run = 0;
+		hal_gpio_sampler_flush();
+	}
+	DMA2->LIFCR = GPIO_SAMPLER_DMA_FLAGS;
+	sampler_running = 0;
+	hal_gpio_tim1_release(GPIO_TIM1_SAMPLER);
+}
+
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Interrupt handlers                                                                                                                    */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+void DMA2_Stream1_IRQHandler(void)
+{
+	uint32_t flags = DMA2->LISR;
+	
+	DMA2->LIFCR = GPIO_SAMPLER_DMA_FLAGS;
+	
+	if (flags & DMA_LISR_TCIF1)
+	{
+		sampler_wraps++;
+	}
+	if (flags & DMA_LISR_TEIF1)
+	{
+		GPIO_SAMPLER_TIMER->DIER &= ~TIM_DIER_CC1DE;
+	}
+}
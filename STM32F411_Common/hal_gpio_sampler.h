@@ -0,0 +1,92 @@
+#ifndef _HAL_GPIO_SAMPLER_H
+#define _HAL_GPIO_SAMPLER_H
+
+#include "hal_gpio_driver.h"
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     DMA GPIO logic sampler                                                                                                                */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/*
+ *  A TIM1 channel 1 compare event once per timer period requests one DMA2 Stream1 (channel 6) transfer of GPIOx->IDR
+ *  into a RAM ring, so the port is sampled at a fixed rate with no CPU involvement. hal_gpio_sampler_process(), called
+ *  from the main loop, run-length compresses the new samples and hands the records to a write function (e.g.
+ *  uart_send_bytes()). The firmware keeps running; the ring only has to absorb the time between two process calls.
+ *
+ *  Binary stream, little endian:
+ *    header  : 'L' 'A' version(1) port(0 = GPIOA ... 7 = GPIOH) rate_hz(u32) mask(u16)
+ *    run     : 0x00 value(u16, IDR & mask) count(varint)        value held for count samples
+ *    overrun : 0x01 lost(varint)                                 samples overwritten before they were read
+ *  varint is 7 bits per byte, least significant first, bit 7 set on all but the last byte.
+ *
+ *  TIM1 is also used by the waveform generator (hal_gpio_wave.h); only one of the two can run at a time.
+ */
+
+#define GPIO_SAMPLER_TIMER                  TIM1
+#define GPIO_SAMPLER_DMA_STREAM             DMA2_Stream1
+#define GPIO_SAMPLER_DMA_CHANNEL            6U
+#define GPIO_SAMPLER_DMA_IRQn               DMA2_Stream1_IRQn
+
+#define GPIO_SAMPLER_RING_LEN               1024U       /* Samples, 2 KB */
+#define GPIO_SAMPLER_MAX_RUN                0x100000U   /* Longer runs are split so idle lines still report */
+#define GPIO_SAMPLER_VERSION                1U
+
+/* Stream record tags */
+#define GPIO_SAMPLER_TAG_RUN                0x00U
+#define GPIO_SAMPLER_TAG_OVERRUN            0x01U
+
+/**
+* @brief   Output function for the compressed stream
+*
+*/
+
+typedef void (*gpio_sampler_write_t)(const uint8_t *data, uint32_t len);
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Enables the TIM1 and DMA2 clocks and sets the sample rate
+  * @param   sample_rate_hz : samples per second
+  * @param   priority       : NVIC priority of the DMA interrupt (counts ring wraps)
+  * @retval  uint8_t: 1 if the rate is valid, 0 for 0 Hz or above SystemCoreClock / 2 (hal_gpio_sampler_start() then fails)
+  */
+
+uint8_t hal_gpio_sampler_init(uint32_t sample_rate_hz, uint32_t priority);
+
+/**
+  * @brief   Starts sampling a port and writes the stream header
+  * @param   *GPIOx : GPIO Port Base address
+  * @param   mask   : pins to record, the others read as 0
+  * @param   write  : output function for the compressed stream
+  * @retval  uint8_t: 1 if started, 0 if already running, the waveform generator holds TIM1 or the rate passed to
+  *          hal_gpio_sampler_init() was invalid
+  */
+
+uint8_t hal_gpio_sampler_start(GPIO_TypeDef *GPIOx, uint16_t mask, gpio_sampler_write_t write);
+
+/**
+  * @brief   Compresses the samples taken since the last call and writes the finished runs
+  * @param   None
+  * @retval  uint32_t: samples consumed
+  */
+
+uint32_t hal_gpio_sampler_process(void);
+
+/**
+  * @brief   Stops sampling, processes the remaining samples and writes the last run
+  * @param   None
+  * @retval  None
+  */
+
+void hal_gpio_sampler_stop(void);
+
+
+#endif
@@ -0,0 +1,191 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "hal_gpio_wave.h"
+
+
+static volatile uint8_t wave_busy;
+static gpio_wave_mode_t wave_mode;
+static gpio_wave_callback_t wave_callback;
+static uint32_t wave_prescaler;                        /* TIM1 PSC and ARR, loaded when the waveform starts */
+static uint32_t wave_period;                           /* 0 until a valid rate is set */
+
+/* DMA2 Stream5 flags in HISR/HIFCR */
+#define GPIO_WAVE_DMA_FLAGS    (DMA_HIFCR_CFEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTCIF5)
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Enables the TIM1 and DMA2 clocks and sets the sample rate
+  * @param   sample_rate_hz : words per second, up to a few MHz
+  * @param   priority       : NVIC priority of the DMA interrupt
+  * @retval  uint8_t: 1 if the rate is valid, 0 for 0 Hz or above SystemCoreClock / 2 (hal_gpio_wave_start() then fails)
+  */
+
+uint8_t hal_gpio_wave_init(uint32_t sample_rate_hz, uint32_t priority)
+{
+	RCC->APB2ENR |= RCC_APB2ENR_TIM1EN;
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+	
+	NVIC_SetPriority(GPIO_WAVE_DMA_IRQn, priority);
+	NVIC_EnableIRQ(GPIO_WAVE_DMA_IRQn);
+	
+	/* TIM1 may be running for the logic sampler, it is only programmed by hal_gpio_wave_start() */
+	if (!hal_gpio_tim1_rate(sample_rate_hz, &wave_prescaler, &wave_period))
+	{
+		wave_period = 0;
+		return 0;
+	}
+	return 1;
+}
+
+/**
+  * @brief   Starts playing a buffer of BSRR words on a port
+  * @param   *GPIOx   : GPIO Port Base address
+  * @param   mode     : playback mode
+  * @param   *buffer0 : first (or only) buffer
+  * @param   *buffer1 : second buffer, double-buffer mode only
+  * @param   length   : words per buffer, 1 - 65535
+  * @param   callback : see the modes in hal_gpio_wave.h, may be NULL
+  * @retval  uint8_t: 1 if started, 0 if a waveform is already playing, the logic sampler holds TIM1 or the rate passed
+  *          to hal_gpio_wave_init() was invalid
+  */
+
+uint8_t hal_gpio_wave_start(GPIO_TypeDef *GPIOx, gpio_wave_mode_t mode, uint32_t *buffer0, uint32_t *buffer1,
+                            uint16_t length, gpio_wave_callback_t callback)
+{
+	uint32_t cr;
+	
+	if (wave_period == 0 || !hal_gpio_tim1_claim(GPIO_TIM1_WAVE))
+	{
+		return 0;
+	}
+	wave_busy = 1;
+	wave_mode = mode;
+	wave_callback = callback;
+	
+	GPIO_WAVE_DMA_STREAM->CR &= ~DMA_SxCR_EN;
+	while (GPIO_WAVE_DMA_STREAM->CR & DMA_SxCR_EN);
+	DMA2->HIFCR = GPIO_WAVE_DMA_FLAGS;
+	
+	GPIO_WAVE_DMA_STREAM->PAR = (uint32_t)&GPIOx->BSRR;
+	GPIO_WAVE_DMA_STREAM->M0AR = (uint32_t)buffer0;
+	GPIO_WAVE_DMA_STREAM->M1AR = (uint32_t)buffer1;
+	GPIO_WAVE_DMA_STREAM->NDTR = length;
+	GPIO_WAVE_DMA_STREAM->FCR = 0;                        /* Direct mode, word to word */
+	
+	/* Memory to peripheral, word sizes, memory increment, very high priority, transfer complete + error interrupts */
+	cr = (GPIO_WAVE_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 |
+	     DMA_SxCR_MINC | DMA_SxCR_DIR_0 | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+	if (mode == GPIO_WAVE_CIRCULAR)
+	{
+		cr |= DMA_SxCR_CIRC;
+	}
+	else if (mode == GPIO_WAVE_DOUBLE_BUFFER)
+	{
+		/* Double buffer implies circular, M0AR plays first */
+		cr |= DMA_SxCR_DBM | DMA_SxCR_CIRC;
+	}
+	GPIO_WAVE_DMA_STREAM->CR = cr;
+	GPIO_WAVE_DMA_STREAM->CR |= DMA_SxCR_EN;
+	
+	/* First word goes out on the first update event, one sample period from now */
+	GPIO_WAVE_TIMER->CR1 = TIM_CR1_URS;
+	GPIO_WAVE_TIMER->PSC = wave_prescaler;
+	GPIO_WAVE_TIMER->ARR = wave_period;
+	GPIO_WAVE_TIMER->EGR = TIM_EGR_UG;                    /* Loads PSC, clears CNT; no DMA request with URS set */
+	GPIO_WAVE_TIMER->SR = 0;
+	GPIO_WAVE_TIMER->DIER = TIM_DIER_UDE;
+	GPIO_WAVE_TIMER->CR1 |= TIM_CR1_CEN;
+	return 1;
+}
+
+/**
+  * @brief   Stops the waveform, the pins keep their last level
+  * @param   None
+  * @retval  None
+  */
+
+void hal_gpio_wave_stop(void)
+{
+	/* TIM1 may belong to the logic sampler */
+	if (!wave_busy)
+	{
+		return;
+	}
+	GPIO_WAVE_TIMER->CR1 &= ~TIM_CR1_CEN;
+	GPIO_WAVE_TIMER->DIER = 0;
+	GPIO_WAVE_DMA_STREAM->CR &= ~DMA_SxCR_EN;
+	while (GPIO_WAVE_DMA_STREAM->CR & DMA_SxCR_EN);
+	DMA2->HIFCR = GPIO_WAVE_DMA_FLAGS;
+	wave_busy = 0;
+	hal_gpio_tim1_release(GPIO_TIM1_WAVE);
+}
+
+/**
+  * @brief   Checks whether a waveform is playing
+  * @param   None
+  * @retval  uint8_t: 1 while playing
+  */
+
+uint8_t hal_gpio_wave_busy(void)
+{
+	return wave_busy;
+}
+
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Interrupt handlers                                                                                                                    */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+void DMA2_Stream5_IRQHandler(void)
+{
+	uint32_t flags = DMA2->HISR;
+	uint32_t *finished;
+	
+	DMA2->HIFCR = GPIO_WAVE_DMA_FLAGS;
+	
+	if (flags & DMA_HISR_TEIF5)
+	{
+		hal_gpio_wave_stop();
+		return;
+	}
+	if (!(flags & DMA_HISR_TCIF5))
+	{
+		return;
+	}
+	
+	switch (wave_mode)
+	{
+		case GPIO_WAVE_ONE_SHOT:
+			hal_gpio_wave_stop();
+			if (wave_callback)
+			{
+				wave_callback(NULL);
+			}
+			break;
+		
+		case GPIO_WAVE_DOUBLE_BUFFER:
+			/* CT already points at the buffer now playing, hand back the other one */
+			finished = (uint32_t *)((GPIO_WAVE_DMA_STREAM->CR & DMA_SxCR_CT) ? GPIO_WAVE_DMA_STREAM->M0AR : GPIO_WAVE_DMA_STREAM->M1AR);
+			if (wave_callback)
+			{
+				wave_callback(finished);
+			}
+			break;
+		
+		default:
+			if (wave_callback)
+			{
+				wave_callback((uint32_t *)GPIO_WAVE_DMA_STREAM->M0AR);
+			}
+			break;
+	}
+}
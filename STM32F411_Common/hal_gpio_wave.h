@@ -0,0 +1,113 @@
+#ifndef _HAL_GPIO_WAVE_H
+#define _HAL_GPIO_WAVE_H
+
+#include "hal_gpio_driver.h"
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     DMA GPIO waveform generator                                                                                                           */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/*
+ *  Every TIM1 update event requests one DMA2 Stream5 (channel 6) transfer of a 32 bit word from RAM into GPIOx->BSRR,
+ *  so each word sets (bits 0-15) and resets (bits 16-31) any pins of the port at a fixed sample rate, with no CPU
+ *  involvement and no interrupt jitter. A word of 0 leaves the port unchanged.
+ *
+ *  One-shot    : the buffer is played once, the callback gets NULL at the end
+ *  Circular    : the buffer is replayed until stopped, the callback gets the buffer at every wrap (may be NULL)
+ *  Double-buffer: buffer 0 and 1 play alternately, the callback gets the buffer that just finished to refill it
+ *                 while the other one plays
+ *
+ *  The callback runs in the DMA interrupt. TIM1 and DMA2 Stream5 are owned by the generator while it runs, so it cannot
+ *  start while the logic sampler (hal_gpio_sampler.h) holds TIM1; the pins must already be configured as outputs (see
+ *  hal_gpio_init_board()).
+ */
+
+/* TIM1 runs from the APB2 timer clock, SystemCoreClock with the reset prescalers */
+#define GPIO_WAVE_TIMER                     TIM1
+#define GPIO_WAVE_DMA_STREAM                DMA2_Stream5
+#define GPIO_WAVE_DMA_CHANNEL               6U
+#define GPIO_WAVE_DMA_IRQn                  DMA2_Stream5_IRQn
+
+/**
+* @brief   Waveform playback mode
+*
+*/
+
+typedef enum
+{
+	GPIO_WAVE_ONE_SHOT,
+	GPIO_WAVE_CIRCULAR,
+	GPIO_WAVE_DOUBLE_BUFFER
+}gpio_wave_mode_t;
+
+/**
+* @brief   Waveform callback, see the modes above
+*
+*/
+
+typedef void (*gpio_wave_callback_t)(uint32_t *buffer);
+
+
+/*************************************************************************************************************************************************************/
+/*                                                                                                                                                           */
+/*                     Driver exposed APIs                                                                                                                   */
+/*                                                                                                                                                           */
+/*************************************************************************************************************************************************************/
+
+/**
+  * @brief   Builds a BSRR word
+  * @param   set_mask   : pins to drive high
+  * @param   reset_mask : pins to drive low (set wins if a pin is in both)
+  * @retval  uint32_t: BSRR word
+  */
+
+static inline uint32_t hal_gpio_wave_word(uint16_t set_mask, uint16_t reset_mask)
+{
+	return ((uint32_t)reset_mask << 16) | set_mask;
+}
+
+/**
+  * @brief   Enables the TIM1 and DMA2 clocks and sets the sample rate
+  * @param   sample_rate_hz : words per second, up to a few MHz
+  * @param   priority       : NVIC priority of the DMA interrupt
+  * @retval  uint8_t: 1 if the rate is valid, 0 for 0 Hz or above SystemCoreClock / 2 (hal_gpio_wave_start() then fails)
+  */
+
+uint8_t hal_gpio_wave_init(uint32_t sample_rate_hz, uint32_t priority);
+
+/**
+  * @brief   Starts playing a buffer of BSRR words on a port
+  * @param   *GPIOx   : GPIO Port Base address
+  * @param   mode     : playback mode
+  * @param   *buffer0 : first (or only) buffer
+  * @param   *buffer1 : second buffer, double-buffer mode only
+  * @param   length   : words per buffer, 1 - 65535
+  * @param   callback : see the modes above, may be NULL
+  * @retval  uint8_t: 1 if started, 0 if a waveform is already playing, the logic sampler holds TIM1 or the rate passed
+  *          to hal_gpio_wave_init() was invalid
+  */
+
+uint8_t hal_gpio_wave_start(GPIO_TypeDef *GPIOx, gpio_wave_mode_t mode, uint32_t *buffer0, uint32_t *buffer1,
+                            uint16_t length, gpio_wave_callback_t callback);
+
+/**
+  * @brief   Stops the waveform, the pins keep their last level
+  * @param   None
+  * @retval  None
+  */
+
+void hal_gpio_wave_stop(void);
+
+/**
+  * @brief   Checks whether a waveform is playing
+  * @param   None
+  * @retval  uint8_t: 1 while playing
+  */
+
+uint8_t hal_gpio_wave_busy(void);
+
+
+#endif
@@ -0,0 +1,81 @@
+
+#include "led.h"
+
+/* User LEDs, push-pull outputs on GPIOD */
+static const gpio_board_pin_t led_pins[] =
+{
+	{ GPIOD, { LED_GREEN,  GPIO_PIN_OUTPUT_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED, 0 } },
+	{ GPIOD, { LED_ORANGE, GPIO_PIN_OUTPUT_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED, 0 } },
+	{ GPIOD, { LED_RED,    GPIO_PIN_OUTPUT_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED, 0 } },
+	{ GPIOD, { LED_BLUE,   GPIO_PIN_OUTPUT_MODE, GPIO_PIN_OP_TYPE_PUSHPULL, GPIO_PIN_NO_PUSH_PULL, GPIO_PIN_SPEED_MED, 0 } },
+};
+
+/**
+  * @brief   Initializes the LEDs and enables the GPIOD clock
+  *          Projects with a board pin table configure the LEDs with it instead, see board_init()
+  * @param   None
+  * @retval  None
+  */
+	
+void led_init(void)
+{
+	
+	hal_gpio_init_board(led_pins, sizeof(led_pins) / sizeof(led_pins[0]));
+	
+}
+
+/**
+  * @brief   Turns on the LED
+  * @param   *GPIOx: Base address of the GPIO port
+  * @param   Pin: pin number of the LED
+  * @retval  None
+  */
+
+ void led_turn_on(GPIO_TypeDef *GPIOx, uint16_t pin)
+{
+	
+	hal_gpio_write_to_pin(GPIOx,pin,1);
+}
+
+
+/**
+  * @brief   Turns off the LED
+  * @param   *GPIOx: Base address of the GPIO port
+  * @param   Pin: pin number of the LED
+  * @retval  None
+  */
+
+ void led_turn_off(GPIO_TypeDef *GPIOx, uint16_t pin)
+{
+	
+	hal_gpio_write_to_pin(GPIOx,pin,0);
+}
+
+/**
+  * @brief   Toggles the LED
+  *          One ODR snapshot and one BSRR store, so an interrupt driving another LED is never undone
+  * @param   *GPIOx: Base address of the GPIO port
+  * @param   Pin: pin number of the LED
+  * @retval  None
+  */
+
+void led_toggle(GPIO_TypeDef *GPIOx, uint16_t pin)
+{
+	
+	hal_gpio_toggle_pin(GPIOx,pin);
+
+}
+
+/**
+  * @brief   Toggles a group of LEDs together, same cost as a single one
+  * @param   *GPIOx: Base address of the GPIO port
+  * @param   mask: LEDs to toggle, bit n is pin n (e.g. LED_ALL_MASK)
+  * @retval  None
+  */
+
+void led_toggle_mask(GPIO_TypeDef *GPIOx, uint16_t mask)
+{
+	
+	hal_gpio_toggle_pins(GPIOx,mask);
+
+}
@@ -0,0 +1,50 @@
+#ifndef  __LED_H
+#define  __LED_H
+
+#include "hal_gpio_driver.h"
+
+
+#define EXTIx_IRQn          EXTI0_IRQn
+#define EXTIx_IRQHandler    EXTI0_IRQHandler    /* Owned by hal_gpio_driver.c, register a callback instead */
+
+#define GPIO_BUTTON_DEBOUNCE_MS    20
+
+
+#define GPIO_BUTTON_PIN     0
+#define GPIO_BUTTON_PORT    GPIOA
+
+#define GPIOD_PIN_12     12
+#define GPIOD_PIN_13     13
+#define GPIOD_PIN_14     14
+#define GPIOD_PIN_15     15
+
+#define LED_GREEN       GPIOD_PIN_12
+#define LED_ORANGE      GPIOD_PIN_13
+#define LED_RED         GPIOD_PIN_14
+#define LED_BLUE        GPIOD_PIN_15
+
+
+/* Compile-time pin accessors: led_<colour>_set/clear/write/toggle/read() and button_read(),
+   each a single access to a constant address, see GPIO_PIN_DEFINE() */
+GPIO_PIN_DEFINE(led_green,  GPIOD_BASE, LED_GREEN)
+GPIO_PIN_DEFINE(led_orange, GPIOD_BASE, LED_ORANGE)
+GPIO_PIN_DEFINE(led_red,    GPIOD_BASE, LED_RED)
+GPIO_PIN_DEFINE(led_blue,   GPIOD_BASE, LED_BLUE)
+GPIO_PIN_DEFINE(button,     GPIOA_BASE, GPIO_BUTTON_PIN)
+
+#define LED_ALL_MASK    ((1U << LED_GREEN) | (1U << LED_ORANGE) | (1U << LED_RED) | (1U << LED_BLUE))
+
+
+ void led_init(void);
+
+ void led_turn_on(GPIO_TypeDef *GPIOx, uint16_t pin);
+
+ void led_turn_off(GPIO_TypeDef *GPIOx, uint16_t pin);
+ 
+ void led_toggle(GPIO_TypeDef *GPIOx, uint16_t pin);
+
+ void led_toggle_mask(GPIO_TypeDef *GPIOx, uint16_t mask);
+
+
+
+#endif
\ No newline at end of file